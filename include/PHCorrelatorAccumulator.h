@@ -0,0 +1,503 @@
+/// ============================================================================
+/*! \file    PHCorrelatorAccumulator.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Class to accumulate histogram contents in flat
+ *  arrays during ENC calculations.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORACCUMULATOR_H
+#define PHCORRELATORACCUMULATOR_H
+
+// c++ utilities
+#include <cassert>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// n.b. atomic (shared) contents need c++11
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <cstring>
+#include <memory>
+#endif
+// root libraries
+#include <TH1.h>
+// analysis components
+#include "PHCorrelatorBinning.h"
+#include "PHCorrelatorHistogram.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Flat histogram accumulator
+  // ==========================================================================
+  /*! Holds the contents of one "family" of histograms, i.e. the same
+   *  histogram definition for every index tag, in contiguous arrays.
+   *  Sums of weights and weights squared are kept for weighted families
+   *  and integer counts for unweighted ones. The layout of cells (incl.
+   *  under/overflow) matches that of TH1/2/3, so contents can be copied
+   *  into ROOT histograms cell-by-cell.
+   *
+   *  With `MakeAtomic`, contents are instead kept in a single block of
+   *  atomics shared by all copies of the accumulator, so that several
+   *  threads can fill the same histograms (see `Type::Atomic`).
+   */
+  class Accumulator {
+
+    private:
+
+      // data members (definition)
+      Histogram           m_def;
+      std::size_t         m_dim;
+      std::size_t         m_nhist;
+      std::size_t         m_ncells;
+      std::size_t         m_ncell_x;
+      std::size_t         m_ncell_y;
+      std::size_t         m_ncell_z;
+      Binning             m_bins_x;
+      Binning             m_bins_y;
+      Binning             m_bins_z;
+      bool                m_weighted;
+
+      // data members (contents)
+      std::vector<double>   m_sumw;
+      std::vector<double>   m_sumw2;
+      std::vector<uint64_t> m_counts;
+      std::vector<double>   m_entries;
+
+      // data members (shared atomic contents)
+      //   - n.b. each histogram is a block of [sumw | sumw2 | entries]
+      //     (or [counts | entries] if unweighted) padded to a whole no.
+      //     of cache lines. Hot histograms get additional "stripe"
+      //     blocks so that threads don't all hit the same cache lines
+      bool m_atomic;
+#if __cplusplus >= 201103L
+      std::shared_ptr< std::vector< std::atomic<uint64_t> > > m_store;
+      std::size_t              m_offset;
+      std::size_t              m_block;
+      std::size_t              m_nstripe;
+      std::vector<std::size_t> m_stripes;
+
+      // ----------------------------------------------------------------------
+      //! Get a block of atomic contents
+      // ----------------------------------------------------------------------
+      /*! Stripe 0 is the histogram's main block. Histograms without
+       *  stripes always use their main block.
+       */
+      std::atomic<uint64_t>* GetBlock(const std::size_t ihist, const std::size_t stripe) const {
+
+        const std::size_t iblock = ((stripe == 0) || (m_stripes[ihist] == 0))
+          ? ihist
+          : m_stripes[ihist] + stripe - 1;
+        return &(*m_store)[m_offset + (iblock * m_block)];
+
+      }  // end 'GetBlock(std::size_t, std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Atomically add to a double
+      // ----------------------------------------------------------------------
+      /*! Doubles are stored as their bit patterns, and added to with a
+       *  compare-and-swap loop.
+       */
+      static void AtomicAdd(std::atomic<uint64_t>& target, const double value) {
+
+        uint64_t old_bits = target.load(std::memory_order_relaxed);
+        uint64_t new_bits = 0;
+        do {
+          double sum = 0.;
+          std::memcpy(&sum, &old_bits, sizeof(double));
+          sum += value;
+          std::memcpy(&new_bits, &sum, sizeof(double));
+        } while (!target.compare_exchange_weak(old_bits, new_bits, std::memory_order_relaxed));
+        return;
+
+      }  // end 'AtomicAdd(std::atomic<uint64_t>&, double)'
+
+      // ----------------------------------------------------------------------
+      //! Atomically read a double
+      // ----------------------------------------------------------------------
+      static double AtomicGet(const std::atomic<uint64_t>& target) {
+
+        const uint64_t bits  = target.load(std::memory_order_relaxed);
+        double         value = 0.;
+        std::memcpy(&value, &bits, sizeof(double));
+        return value;
+
+      }  // end 'AtomicGet(std::atomic<uint64_t>&)'
+
+      // ----------------------------------------------------------------------
+      //! Get slot of calling thread
+      // ----------------------------------------------------------------------
+      /*! Each thread gets the next slot the 1st time it asks, and
+       *  picks its stripe of hot histograms from it.
+       */
+      static std::size_t GetThreadSlot() {
+
+        static std::atomic<std::size_t> next(0);
+        thread_local std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+
+      }  // end 'GetThreadSlot()'
+
+      // ----------------------------------------------------------------------
+      //! Add a weight to a cell of a histogram (atomic contents)
+      // ----------------------------------------------------------------------
+      void FillAtomic(const std::size_t ihist, const std::size_t cell, const double weight) {
+
+        std::atomic<uint64_t>* block = GetBlock(ihist, GetThreadSlot() % m_nstripe);
+        if (m_weighted) {
+          AtomicAdd(block[cell], weight);
+          AtomicAdd(block[m_ncells + cell], weight * weight);
+          block[2 * m_ncells].fetch_add(1, std::memory_order_relaxed);
+        } else {
+          block[cell].fetch_add(1, std::memory_order_relaxed);
+          block[m_ncells].fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+
+      }  // end 'FillAtomic(std::size_t, std::size_t, double)'
+
+      // ----------------------------------------------------------------------
+      //! Sum an element of a histogram's blocks (atomic contents)
+      // ----------------------------------------------------------------------
+      /*! Stripes are summed in a fixed order. `isdouble` says whether
+       *  the element holds a double or an integer count.
+       */
+      double SumAtomic(const std::size_t ihist, const std::size_t element, const bool isdouble) const {
+
+        const std::size_t nstripe = (m_stripes[ihist] == 0) ? 1 : m_nstripe;
+
+        double sum = 0.;
+        for (std::size_t stripe = 0; stripe < nstripe; ++stripe) {
+          const std::atomic<uint64_t>& value = GetBlock(ihist, stripe)[element];
+          sum += isdouble ? AtomicGet(value) : (double) value.load(std::memory_order_relaxed);
+        }
+        return sum;
+
+      }  // end 'SumAtomic(std::size_t, std::size_t, bool)'
+#endif
+
+    public:
+
+      // ----------------------------------------------------------------------
+      //! Getters
+      // ----------------------------------------------------------------------
+      Histogram   GetDef()      const {return m_def;}
+      std::size_t GetDim()      const {return m_dim;}
+      std::size_t GetNHists()   const {return m_nhist;}
+      std::size_t GetNCells()   const {return m_ncells;}
+      bool        GetWeighted() const {return m_weighted;}
+      bool        GetAtomic()   const {return m_atomic;}
+
+      // ----------------------------------------------------------------------
+      //! Get cell of a (x, y, z) bin
+      // ----------------------------------------------------------------------
+      std::size_t GetCell(const std::size_t ix, const std::size_t iy = 0, const std::size_t iz = 0) const {
+
+        return ix + (m_ncell_x * (iy + (m_ncell_y * iz)));
+
+      }  // end 'GetCell(std::size_t x 3)'
+
+      // ----------------------------------------------------------------------
+      //! Find bin of a value along an axis
+      // ----------------------------------------------------------------------
+      /*! These allow a bin to be found once and then reused across
+       *  accumulators sharing an axis.
+       */
+      std::size_t FindBinX(const double x) const {return m_bins_x.FindBin(x);}
+      std::size_t FindBinY(const double y) const {return m_bins_y.FindBin(y);}
+      std::size_t FindBinZ(const double z) const {return m_bins_z.FindBin(z);}
+
+      // ----------------------------------------------------------------------
+      //! Find cell of a value
+      // ----------------------------------------------------------------------
+      std::size_t FindCell(const double x) const {
+        return FindBinX(x);
+      }
+
+      std::size_t FindCell(const double x, const double y) const {
+        return GetCell(FindBinX(x), FindBinY(y));
+      }
+
+      std::size_t FindCell(const double x, const double y, const double z) const {
+        return GetCell(FindBinX(x), FindBinY(y), FindBinZ(z));
+      }
+
+      // ----------------------------------------------------------------------
+      //! Add a weight to a cell of a histogram
+      // ----------------------------------------------------------------------
+      void FillCell(const std::size_t ihist, const std::size_t cell, const double weight) {
+
+#if __cplusplus >= 201103L
+        if (m_atomic) {
+          FillAtomic(ihist, cell, weight);
+          return;
+        }
+#endif
+
+        const std::size_t icell = (ihist * m_ncells) + cell;
+        if (m_weighted) {
+          m_sumw[icell]  += weight;
+          m_sumw2[icell] += weight * weight;
+        } else {
+          ++m_counts[icell];
+        }
+        m_entries[ihist] += 1.0;
+        return;
+
+      }  // end 'FillCell(std::size_t, std::size_t, double)'
+
+      // ----------------------------------------------------------------------
+      //! Fill a histogram
+      // ----------------------------------------------------------------------
+      /*! N.B. for unweighted families, the weight is ignored.
+       */
+      void Fill(const std::size_t ihist, const double x, const double weight = 1.0) {
+        FillCell(ihist, FindCell(x), weight);
+      }
+
+      void Fill(const std::size_t ihist, const double x, const double y, const double weight) {
+        FillCell(ihist, FindCell(x, y), weight);
+      }
+
+      void Fill(const std::size_t ihist, const double x, const double y, const double z, const double weight) {
+        FillCell(ihist, FindCell(x, y, z), weight);
+      }
+
+      // ----------------------------------------------------------------------
+      //! Get contents of a cell
+      // ----------------------------------------------------------------------
+      double GetSumW(const std::size_t ihist, const std::size_t cell) const {
+
+#if __cplusplus >= 201103L
+        if (m_atomic) return SumAtomic(ihist, cell, m_weighted);
+#endif
+
+        const std::size_t icell = (ihist * m_ncells) + cell;
+        return m_weighted ? m_sumw[icell] : (double) m_counts[icell];
+
+      }  // end 'GetSumW(std::size_t, std::size_t)'
+
+      double GetSumW2(const std::size_t ihist, const std::size_t cell) const {
+
+#if __cplusplus >= 201103L
+        if (m_atomic) return m_weighted ? SumAtomic(ihist, m_ncells + cell, true) : SumAtomic(ihist, cell, false);
+#endif
+
+        const std::size_t icell = (ihist * m_ncells) + cell;
+        return m_weighted ? m_sumw2[icell] : (double) m_counts[icell];
+
+      }  // end 'GetSumW2(std::size_t, std::size_t)'
+
+      double GetEntries(const std::size_t ihist) const {
+
+#if __cplusplus >= 201103L
+        if (m_atomic) return SumAtomic(ihist, m_weighted ? 2 * m_ncells : m_ncells, false);
+#endif
+        return m_entries[ihist];
+
+      }  // end 'GetEntries(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Switch to shared atomic contents
+      // ----------------------------------------------------------------------
+      /*! After this, all copies of the accumulator share the same
+       *  contents, which can be filled from several threads at once.
+       *  Histograms flagged in `hot` (e.g. the integrated ones, which
+       *  every pair fills) get `nstripe` blocks, one of which is
+       *  picked by each thread. Should be called before filling; needs
+       *  c++11.
+       */
+      void MakeAtomic(const std::vector<bool>& hot, const std::size_t nstripe) {
+
+#if __cplusplus >= 201103L
+        // elements per cache line
+        const std::size_t nline = 64 / sizeof(uint64_t);
+
+        // size of each block, padded to a whole no. of cache lines
+        const std::size_t nelem = (m_weighted ? 2 * m_ncells : m_ncells) + 1;
+        m_block   = ((nelem + nline - 1) / nline) * nline;
+        m_nstripe = (nstripe > 0) ? nstripe : 1;
+
+        // assign stripe blocks to hot histograms
+        std::size_t nblock = m_nhist;
+        m_stripes.assign(m_nhist, 0);
+        for (std::size_t ihist = 0; ihist < m_nhist; ++ihist) {
+          if ((ihist < hot.size()) && hot[ihist] && (m_nstripe > 1)) {
+            m_stripes[ihist] = nblock;
+            nblock += m_nstripe - 1;
+          }
+        }
+
+        // allocate zeroed contents, and align 1st block to a cache line
+        m_store.reset( new std::vector< std::atomic<uint64_t> >((nblock * m_block) + nline) );
+        for (std::size_t ielem = 0; ielem < m_store -> size(); ++ielem) {
+          (*m_store)[ielem].store(0, std::memory_order_relaxed);
+        }
+        const std::size_t address = reinterpret_cast<std::size_t>( &(*m_store)[0] );
+        m_offset = ((64 - (address % 64)) % 64) / sizeof(uint64_t);
+
+        // then release flat contents
+        std::vector<double>().swap(m_sumw);
+        std::vector<double>().swap(m_sumw2);
+        std::vector<uint64_t>().swap(m_counts);
+        std::vector<double>().swap(m_entries);
+        m_atomic = true;
+#else
+        // throw error if atomics aren't available
+        const bool has_atomics = false;
+        if (!has_atomics) {
+          assert(has_atomics);
+        }
+        (void) hot;
+        (void) nstripe;
+#endif
+        return;
+
+      }  // end 'MakeAtomic(std::vector<bool>&, std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Check if contents are shared with another accumulator
+      // ----------------------------------------------------------------------
+      bool SharesWith(const Accumulator& other) const {
+
+#if __cplusplus >= 201103L
+        return m_atomic && (m_store == other.m_store);
+#else
+        (void) other;
+        return false;
+#endif
+
+      }  // end 'SharesWith(Accumulator&)'
+
+      // ----------------------------------------------------------------------
+      //! Add contents of another accumulator
+      // ----------------------------------------------------------------------
+      void Add(const Accumulator& other) {
+
+        // if contents are shared, there's nothing to add
+        if (SharesWith(other)) return;
+
+#if __cplusplus >= 201103L
+        // if atomic, add contents of other into main blocks
+        if (m_atomic || other.m_atomic) {
+          if ((m_atomic != other.m_atomic) || (m_ncells != other.m_ncells) || (m_nhist != other.m_nhist)) {
+            assert((m_atomic == other.m_atomic) && (m_ncells == other.m_ncells) && (m_nhist == other.m_nhist));
+          }
+          for (std::size_t ihist = 0; ihist < m_nhist; ++ihist) {
+            std::atomic<uint64_t>* block = GetBlock(ihist, 0);
+            for (std::size_t cell = 0; cell < m_ncells; ++cell) {
+              if (m_weighted) {
+                AtomicAdd(block[cell], other.GetSumW(ihist, cell));
+                AtomicAdd(block[m_ncells + cell], other.GetSumW2(ihist, cell));
+              } else {
+                block[cell].fetch_add((uint64_t) other.GetSumW(ihist, cell), std::memory_order_relaxed);
+              }
+            }
+            block[m_weighted ? 2 * m_ncells : m_ncells].fetch_add(
+              (uint64_t) other.GetEntries(ihist),
+              std::memory_order_relaxed
+            );
+          }
+          return;
+        }
+#endif
+
+        // throw error if layouts don't match
+        if ((other.m_sumw.size() != m_sumw.size()) || (other.m_counts.size() != m_counts.size())) {
+          assert((other.m_sumw.size() == m_sumw.size()) && (other.m_counts.size() == m_counts.size()));
+        }
+
+        for (std::size_t icell = 0; icell < m_sumw.size(); ++icell) {
+          m_sumw[icell]  += other.m_sumw[icell];
+          m_sumw2[icell] += other.m_sumw2[icell];
+        }
+        for (std::size_t icell = 0; icell < m_counts.size(); ++icell) {
+          m_counts[icell] += other.m_counts[icell];
+        }
+        for (std::size_t ihist = 0; ihist < m_nhist; ++ihist) {
+          m_entries[ihist] += other.m_entries[ihist];
+        }
+        return;
+
+      }  // end 'Add(Accumulator&)'
+
+      // ----------------------------------------------------------------------
+      //! Copy contents of a histogram into a ROOT histogram
+      // ----------------------------------------------------------------------
+      /*! Sums of weights squared are copied directly into the
+       *  histogram's Sumw2 array so that errors are exact.
+       */
+      void CopyTo(const std::size_t ihist, TH1* hist) const {
+
+        for (std::size_t cell = 0; cell < m_ncells; ++cell) {
+          hist -> SetBinContent(cell, GetSumW(ihist, cell));
+          if (hist -> GetSumw2N() > 0) {
+            hist -> GetSumw2() -> fArray[cell] = GetSumW2(ihist, cell);
+          }
+        }
+
+        // n.b. SetBinContent increments entries, so set them last
+        hist -> SetEntries( GetEntries(ihist) );
+        return;
+
+      }  // end 'CopyTo(std::size_t, TH1*)'
+
+      // ----------------------------------------------------------------------
+      //! default ctor/dtor
+      // ----------------------------------------------------------------------
+      Accumulator() : m_atomic(false) {};
+      ~Accumulator() {};
+
+      // ----------------------------------------------------------------------
+      //! ctor accepting arguments
+      // ----------------------------------------------------------------------
+      /*! Accumulates `nhist` histograms of dimension `dim`
+       *  defined by `def`.
+       */
+      Accumulator(
+        const Histogram& def,
+        const std::size_t nhist,
+        const std::size_t dim,
+        const bool weighted = true
+      ) {
+
+        m_def      = def;
+        m_dim      = dim;
+        m_nhist    = nhist;
+        m_weighted = weighted;
+        m_atomic   = false;
+
+        // grab binning of relevant axes
+        //   - n.b. an unused axis has only 1 cell
+        m_bins_x = def.GetBinsX();
+        if (dim > 1) m_bins_y = def.GetBinsY();
+        if (dim > 2) m_bins_z = def.GetBinsZ();
+        m_ncell_x = m_bins_x.GetNum() + 2;
+        m_ncell_y = (dim > 1) ? m_bins_y.GetNum() + 2 : 1;
+        m_ncell_z = (dim > 2) ? m_bins_z.GetNum() + 2 : 1;
+        m_ncells  = m_ncell_x * m_ncell_y * m_ncell_z;
+
+        // allocate contents
+        if (m_weighted) {
+          m_sumw.assign(m_nhist * m_ncells, 0.0);
+          m_sumw2.assign(m_nhist * m_ncells, 0.0);
+        } else {
+          m_counts.assign(m_nhist * m_ncells, 0);
+        }
+        m_entries.assign(m_nhist, 0.0);
+
+      }  // end ctor(Histogram&, std::size_t, std::size_t, bool)
+
+  };  // end Accumulator
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <stdint.h>
 #include <vector>
 // root libraries
 #include <TH1.h>
@@ -22,6 +23,7 @@
 // analysis components
 #include "PHCorrelatorAnaTypes.h"
 #include "PHCorrelatorConstants.h"
+#include "PHCorrelatorVectors.h"
 
 
 
@@ -65,6 +67,34 @@ namespace PHEnergyCorrelator {
 
 
 
+    // ------------------------------------------------------------------------
+    //! Check if a constituent is charged
+    // ------------------------------------------------------------------------
+    /*! Meant to be used as a selection predicate for per-jet
+     *  calculations, e.g. `Calculator::CalcEECJet`.
+     */
+    bool IsChargedCst(const Type::Cst& cst) {
+
+      return (cst.chrg != 0.0);
+
+    }  // end 'IsChargedCst(Type::Cst&)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get momentum fraction of a constituent
+    // ------------------------------------------------------------------------
+    /*! Meant to be used as a score for picking the leading constituent
+     *  of a jet, e.g. `Calculator::SetLambdaScore`.
+     */
+    double GetCstZ(const Type::Cst& cst) {
+
+      return cst.z;
+
+    }  // end 'GetCstZ(Type::Cst&)'
+
+
+
     // ------------------------------------------------------------------------
     //! Get variance from a standard error + counts
     // ------------------------------------------------------------------------
@@ -201,14 +231,14 @@ namespace PHEnergyCorrelator {
     // ------------------------------------------------------------------------
     //! Get jet 4-vector in cartesian coordinates from jet info
     // ------------------------------------------------------------------------
-    /*! Returns jet lorentz vector based on a Type::Jet. Note that the
+    /*! Returns jet 4-vector based on a Type::Jet. Note that the
      *  energy of the vector is set to be the magnitude of the jet 3-
      *  vector.
      *
      *  If `norm` is set to true, vector will be normalized by
      *  its magnitude
      */
-    TLorentzVector GetJetLorentz(const Type::Jet& jet, const bool norm = false) {
+    Type::Vec4 GetJetVec(const Type::Jet& jet, const bool norm = false) {
 
       // calculate momentum components
       const double th = 2.0 * atan( exp(-1.0 * jet.eta) );
@@ -217,13 +247,26 @@ namespace PHEnergyCorrelator {
       const double py = (pz / cos(th)) * sin(jet.phi);
 
       // normalize if need be
-      TVector3 vector(px, py, pz);
+      Type::Vec3 vector(px, py, pz);
       if (norm) {
         vector *= (1.0 / vector.Mag());
       }
 
       // return 4-vector
-      return TLorentzVector(vector.Px(), vector.Py(), vector.Pz(), vector.Mag());
+      return Type::Vec4(vector, vector.Mag());
+
+    }  // end 'GetJetVec(Type::Jet&, bool)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get jet lorentz vector in cartesian coordinates from jet info
+    // ------------------------------------------------------------------------
+    /*! ROOT version of `GetJetVec`.
+     */
+    TLorentzVector GetJetLorentz(const Type::Jet& jet, const bool norm = false) {
+
+      return GetJetVec(jet, norm).ToTLorentzVector();
 
     }  // end 'GetJetLorentz(Type::Jet&, bool)'
 
@@ -232,14 +275,14 @@ namespace PHEnergyCorrelator {
     // ------------------------------------------------------------------------
     //! Get constituent 4-vector in cartesian coordinates from cst info
     // ------------------------------------------------------------------------
-    /*! Returns cst lorentz vector based on a Type::Cst and the pt of a jet.
+    /*! Returns cst 4-vector based on a Type::Cst and the pt of a jet.
      *  Note that the energy of the vector is set to be the magnitude of the
      *  jet 3-vector.
      *
      *  If `norm` is set to true, vector will be normalized by
      *  its magnitude
      */
-    TLorentzVector GetCstLorentz(
+    Type::Vec4 GetCstVec(
       const Type::Cst& cst,
       const double ptJet,
       const bool norm = false
@@ -256,13 +299,30 @@ namespace PHEnergyCorrelator {
       const double pz = pCst * cos(th);
 
       // normalize if need be
-      TVector3 vector(px, py, pz);
+      Type::Vec3 vector(px, py, pz);
       if (norm) {
         vector *= (1.0 / vector.Mag());
       }
 
-      // return 3-vector
-      return TLorentzVector(vector.Px(), vector.Py(), vector.Pz(), vector.Mag());
+      // return 4-vector
+      return Type::Vec4(vector, vector.Mag());
+
+    }  // end 'GetCstVec(Types::Cst&, double, bool)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get constituent lorentz vector in cartesian coordinates from cst info
+    // ------------------------------------------------------------------------
+    /*! ROOT version of `GetCstVec`.
+     */
+    TLorentzVector GetCstLorentz(
+      const Type::Cst& cst,
+      const double ptJet,
+      const bool norm = false
+    ) {
+
+      return GetCstVec(cst, ptJet, norm).ToTLorentzVector();
 
     }  // end 'GetCstLorentz(Types::Cst&, double, bool)'
 
@@ -271,9 +331,9 @@ namespace PHEnergyCorrelator {
     // ------------------------------------------------------------------------
     //! Get magnitude-weighted average of two 3-vectors
     // ------------------------------------------------------------------------
-    TVector3 GetWeightedAvgVector(
-      const TVector3& va,
-      const TVector3& vb,
+    Type::Vec3 GetWeightedAvgVec(
+      const Type::Vec3& va,
+      const Type::Vec3& vb,
       const bool norm = false
     ) {
 
@@ -282,16 +342,33 @@ namespace PHEnergyCorrelator {
       const double wb = vb.Mag() / (va.Mag() + vb.Mag());
 
       // scale vectors
-      const TVector3 sva = va * wa;
-      const TVector3 svb = vb * wb;
+      const Type::Vec3 sva = va * wa;
+      const Type::Vec3 svb = vb * wb;
 
       // sum and norm (if needed)
-      TVector3 sum = sva + svb;
+      Type::Vec3 sum = sva + svb;
       if (norm) {
         sum *= (1.0 / sum.Mag());
       }
       return sum;
 
+    }  // end 'GetWeightedAvgVec(Type::Vec3& x 2, bool)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get magnitude-weighted average of two TVector3s
+    // ------------------------------------------------------------------------
+    /*! ROOT version of `GetWeightedAvgVec`.
+     */
+    TVector3 GetWeightedAvgVector(
+      const TVector3& va,
+      const TVector3& vb,
+      const bool norm = false
+    ) {
+
+      return GetWeightedAvgVec(Type::Vec3(va), Type::Vec3(vb), norm).ToTVector3();
+
     }  // end 'GetWeightedAvgVector(TVector3& x 2, bool)'
 
 
@@ -299,6 +376,20 @@ namespace PHEnergyCorrelator {
     // ------------------------------------------------------------------------
     //! Get beam directions
     // ------------------------------------------------------------------------
+    std::pair<Type::Vec3, Type::Vec3> GetBeamVecs() {
+
+      return std::make_pair(
+        Type::Vec3(Const::BlueBeam()),
+        Type::Vec3(Const::YellowBeam())
+      );
+
+    }  // end 'GetBeamVecs()'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get beam directions as TVector3s
+    // ------------------------------------------------------------------------
     std::pair<TVector3, TVector3> GetBeams() {
 
       return std::make_pair(Const::BlueBeam(), Const::YellowBeam());
@@ -307,14 +398,71 @@ namespace PHEnergyCorrelator {
 
 
 
+    // ------------------------------------------------------------------------
+    //! Scramble bits of a 64-bit integer
+    // ------------------------------------------------------------------------
+    /*! This is the SplitMix64 finalizer: every bit of the input
+     *  affects every bit of the output.
+     */
+    uint64_t MixBits(const uint64_t arg) {
+
+      uint64_t bits = arg + 0x9E3779B97F4A7C15ULL;
+      bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+      return bits ^ (bits >> 31);
+
+    }  // end 'MixBits(uint64_t)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get a uniform random number in [0, 1) from a counter
+    // ------------------------------------------------------------------------
+    /*! Counter-based generator: the number is a pure function of
+     *  (seed, event, jet, counter), so there's no state to share
+     *  between threads and results don't depend on the order in
+     *  which jets are processed.
+     */
+    double GetCounterUniform(
+      const uint64_t seed,
+      const uint64_t event,
+      const uint64_t jet,
+      const uint64_t counter
+    ) {
+
+      uint64_t key = MixBits(seed);
+      key = MixBits(key ^ event);
+      key = MixBits(key ^ jet);
+      key = MixBits(key ^ counter);
+
+      // keep top 53 bits to fill the mantissa
+      return (double) (key >> 11) * (1.0 / 9007199254740992.0);
+
+    }  // end 'GetCounterUniform(uint64_t x 4)'
+
+
+
     // ------------------------------------------------------------------------
     //! Get spins based on a provided spin pattern
     // ------------------------------------------------------------------------
     /*! Returns a pair of spin vectors based on a provided spin pattern.
      *  The 1st element will always be the blue spin, and the 2nd the
      *  yellow.
+     *
+     *  Null spins are drawn with `GetCounterUniform` keyed by (seed,
+     *  event, jet), where `draw` numbers the draws made for a jet.
      */
-    std::pair<TVector3, TVector3> GetSpins(const int pattern) { 
+    std::pair<TVector3, TVector3> GetSpins(
+      const int pattern,
+      const uint64_t seed = Const::SpinSeed(),
+      const uint64_t event = 0,
+      const uint64_t jet = 0,
+      const uint64_t draw = 0
+    ) {
+
+      // counters for (blue, yellow) null spins
+      const uint64_t cblue = 4 * draw;
+      const uint64_t cyell = (4 * draw) + 2;
 
       TVector3 blue(0.0, 0.0, 0.0);
       TVector3 yellow(0.0, 0.0, 0.0);
@@ -347,25 +495,55 @@ namespace PHEnergyCorrelator {
         // blue up (pAu)
         case Type::PABU:
           blue   = Const::SpinUp();
-          yellow = Const::SpinNull();
+          yellow = Const::SpinNull(
+            GetCounterUniform(seed, event, jet, cyell),
+            GetCounterUniform(seed, event, jet, cyell + 1)
+          );
           break;
 
         // blue down (pAu)
         case Type::PABD:
           blue   = Const::SpinDown();
-          yellow = Const::SpinNull();
+          yellow = Const::SpinNull(
+            GetCounterUniform(seed, event, jet, cyell),
+            GetCounterUniform(seed, event, jet, cyell + 1)
+          );
           break;
 
         // by default, return both as null vectors
         default:
-          blue   = Const::SpinNull();
-          yellow = Const::SpinNull();
+          blue   = Const::SpinNull(
+            GetCounterUniform(seed, event, jet, cblue),
+            GetCounterUniform(seed, event, jet, cblue + 1)
+          );
+          yellow = Const::SpinNull(
+            GetCounterUniform(seed, event, jet, cyell),
+            GetCounterUniform(seed, event, jet, cyell + 1)
+          );
           break;
 
       }
       return std::make_pair(blue, yellow);
 
-    }  // end 'GetSpins(int)'
+    }  // end 'GetSpins(int, uint64_t x 4)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get spins based on a provided spin pattern as plain vectors
+    // ------------------------------------------------------------------------
+    std::pair<Type::Vec3, Type::Vec3> GetSpinVecs(
+      const int pattern,
+      const uint64_t seed = Const::SpinSeed(),
+      const uint64_t event = 0,
+      const uint64_t jet = 0,
+      const uint64_t draw = 0
+    ) {
+
+      const std::pair<TVector3, TVector3> spins = GetSpins(pattern, seed, event, jet, draw);
+      return std::make_pair(Type::Vec3(spins.first), Type::Vec3(spins.second));
+
+    }  // end 'GetSpinVecs(int, uint64_t x 4)'
 
   }  // end Tools namespace
 }  // end PHEnergyCorrelator namespace
@@ -10,6 +10,9 @@
 #ifndef PHCORRELATORANATYPES_H
 #define PHCORRELATORANATYPES_H
 
+// c++ utilities
+#include <cassert>
+#include <string>
 // analysis components
 #include "PHCorrelatorConstants.h"
 
@@ -23,6 +26,28 @@ namespace PHEnergyCorrelator {
     // ------------------------------------------------------------------------
     enum Axis {Log, Norm};
 
+    // ------------------------------------------------------------------------
+    //! Histogram backends
+    // ------------------------------------------------------------------------
+    enum Backend {
+      Root,  /*!< fill ROOT histograms directly */
+      Flat,  /*!< fill flat arrays, convert to ROOT histograms when saving */
+      Atomic /*!< as Flat, but arrays are shared by clones and filled atomically (needs c++11) */
+    };
+
+    // ------------------------------------------------------------------------
+    //! Pair-loop paths of per-jet EEC calculations
+    // ------------------------------------------------------------------------
+    /*! See `Dispatcher`.
+     */
+    enum Path {
+      Scalar,   /*!< `CalcEECJet` with scalar kernels */
+      SIMDRow,  /*!< `CalcEECJet` with the best vectorized kernels */
+      Batched,  /*!< `BatchEECJet`, i.e. pair slots across jets */
+      Threaded, /*!< `Parallel::JetPool`, i.e. tiles of pairs across threads (needs c++11) */
+      Auto      /*!< pick fastest of the above by multiplicity */
+    };
+
     // ------------------------------------------------------------------------
     //! Weight types
     // ------------------------------------------------------------------------
@@ -32,6 +57,32 @@ namespace PHEnergyCorrelator {
       Pt   /*!< weight by transverse momentum (lab frame) */
     };
 
+    // ------------------------------------------------------------------------
+    //! Weight scheme
+    // ------------------------------------------------------------------------
+    /*! A (weight type, power) combination, and the tag of the
+     *  histograms it fills.
+     */
+    struct WeightScheme {
+
+      // data members
+      Weight      type;
+      double      power;
+      std::string tag;
+
+      //! default ctor/dtor
+      WeightScheme()  {};
+      ~WeightScheme() {};
+
+      //! ctor accepting arguments
+      WeightScheme(const Weight warg, const double parg, const std::string& targ) {
+        type  = warg;
+        power = parg;
+        tag   = targ;
+      }  // end ctor(Weight, double, std::string&)
+
+    };  // end WeightScheme
+
     // ----------------------------------------------------------------------
     //! Possible spin patterns
     // ----------------------------------------------------------------------
@@ -151,6 +202,54 @@ namespace PHEnergyCorrelator {
 
 
 
+    // ------------------------------------------------------------------------
+    //! Fixed-capacity list of histogram indices
+    // ------------------------------------------------------------------------
+    /*! A jet fills at most 16 histogram indices (4 pt x charge
+     *  combinations for each of up to 4 spin combinations, see
+     *  `BasicCalculator::GetHistIndices`), so they're stored inline
+     *  rather than on the heap: building, copying and passing a list
+     *  around never allocates.
+     */
+    struct IndexList {
+
+      // n.b. enum so it can size an array in c++98
+      enum {Capacity = 16};
+
+      // data members
+      HistIndex   entries[Capacity];
+      std::size_t count;
+
+      //! get no. of indices
+      std::size_t Size()  const {return count;}
+      bool        Empty() const {return count == 0;}
+
+      //! access indices
+      const HistIndex& operator[](const std::size_t idx) const {return entries[idx];}
+      const HistIndex& Back() const {return entries[count - 1];}
+
+      //! empty list
+      void Clear() {count = 0;}
+
+      //! add an index
+      void Add(const HistIndex& index) {
+
+        // throw error if list is full
+        if (count >= Capacity) {
+          assert(count < Capacity);
+        }
+        entries[count++] = index;
+
+      }  // end 'Add(HistIndex&)'
+
+      //! default ctor/dtor
+      IndexList() : count(0) {};
+      ~IndexList() {};
+
+    };  // end IndexList
+
+
+
     // ------------------------------------------------------------------------
     //! Histogram content
     // ------------------------------------------------------------------------
@@ -172,7 +271,21 @@ namespace PHEnergyCorrelator {
       int    pattern;  //!< spin pattern
 
       //! default ctor/dtor
-      HistContent()  {};
+      HistContent() {
+        weight   = Const::DoubleDefault();
+        rl       = Const::DoubleDefault();
+        rm       = Const::DoubleDefault();
+        rs       = Const::DoubleDefault();
+        xi       = Const::DoubleDefault();
+        theta    = Const::DoubleDefault();
+        phiCollB = Const::DoubleDefault();
+        phiCollY = Const::DoubleDefault();
+        phiBoerB = Const::DoubleDefault();
+        phiBoerY = Const::DoubleDefault();
+        spinB    = Const::DoubleDefault();
+        spinY    = Const::DoubleDefault();
+        pattern  = Const::IntDefault();
+      }  // end ctor()
       ~HistContent() {};
 
       //! ctor accepting only 2-point arguments
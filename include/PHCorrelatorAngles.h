@@ -0,0 +1,388 @@
+/// ============================================================================
+/*! \file    PHCorrelatorAngles.h
+ *  \authors Derek Anderson, Alex Clarke
+ *  \date    10.15.2026
+ *
+ *  Angle policies for the ENC calculator: each
+ *  one defines the spin-dependent angles of a
+ *  particular analysis.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORANGLES_H
+#define PHCORRELATORANGLES_H
+
+// c++ utilities
+#include <cmath>
+#include <utility>
+#include <vector>
+// root libraries
+#include <TMath.h>
+// analysis components
+#include "PHCorrelatorAnaTools.h"
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorBatch.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorSpinGeometry.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Dihadron FF angles
+  // ==========================================================================
+  /*! Fills the "Collins" slots of the histogram content with the
+   *  difference between the spin and dihadron (R_C) angles for
+   *  each beam. There are no Boer-Mulders-like angles, so those
+   *  histograms are not booked.
+   *
+   *  Each policy provides `Calc` for a single pair, `CalcRow` for a
+   *  row of pairs (ia, ib <= ia) of a jet, and `CalcSlot` for the
+   *  same pair slot (ia, ib) of every jet in a `JetBatch`. Beam and
+   *  spin vectors are taken from a `SpinGeometry::Config`.
+   */
+  struct DiFFAngles {
+
+    //! whether or not boer-mulders histograms are produced
+    static const bool DoBoerMulders = false;
+
+    //! whether or not the unit jet 4-momentum is used
+    static const bool UsesJetAxis = false;
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a pair
+    // ------------------------------------------------------------------------
+    static void Calc(
+      const Type::Jet& jet,
+      const Type::Vec4& unitJet4,
+      const std::pair<Type::Vec4, Type::Vec4>& vecCst4,
+      const SpinGeometry::Config& spin,
+      Type::HistContent& content
+    ) {
+
+      // n.b. only the constituents are needed
+      (void) unitJet4;
+
+      // (0) get beam and spin directions
+      //   first  = blue beam/spin
+      //   second = yellow beam/spin
+      const std::pair<Type::Vec3, Type::Vec3>& vecBeam3 = spin.beams;
+      const std::pair<Type::Vec3, Type::Vec3>& vecSpin3 = spin.spins;
+
+      // Define the vectors for the angle calculations
+
+      Type::Vec3 PC = vecCst4.first.Vect() + vecCst4.second.Vect();
+      Type::Vec3 PC_unit = PC.Unit();
+      Type::Vec3 RC = 0.5*(vecCst4.first.Vect() - vecCst4.second.Vect());
+
+      // blue beam is PB, yellow is PA
+
+      Type::Vec3 PB = vecBeam3.first;
+      Type::Vec3 PB_unit = PB.Unit();
+      Type::Vec3 SB = vecSpin3.first;
+
+      Type::Vec3 PA = vecBeam3.second;
+      Type::Vec3 PA_unit = PA.Unit();
+      Type::Vec3 SA = vecSpin3.second;
+
+      // Blue Polarized
+
+      double cThetaSB = (PB_unit.Cross(PC)*(1.0/(PB_unit.Cross(PC).Mag()))).Dot(PB_unit.Cross(SB)*(1.0/PB_unit.Cross(SB).Mag()));
+      double sThetaSB = (PC.Cross(SB)).Dot(PB_unit)*(1.0/((PB_unit.Cross(PC).Mag())*(PB_unit.Cross(SB).Mag())));
+
+      // Yellow Polarized
+
+      double cThetaSA = (PA_unit.Cross(PC)*(1.0/(PA_unit.Cross(PC).Mag()))).Dot(PA_unit.Cross(SA)*(1.0/PA_unit.Cross(SA).Mag()));
+      double sThetaSA = (PC.Cross(SA)).Dot(PA_unit)*(1.0/((PA_unit.Cross(PC).Mag())*(PA_unit.Cross(SA).Mag())));
+
+      // Dihadron
+
+      double cThetaRC = (PC_unit.Cross(PA)*(1.0/(PC_unit.Cross(PA).Mag()))).Dot(PC_unit.Cross(RC)*(1.0/PC_unit.Cross(RC).Mag()));
+      double sThetaRC = (PA.Cross(RC)).Dot(PC_unit)*(1.0/((PC_unit.Cross(PA).Mag())*(PC_unit.Cross(RC).Mag())));
+
+      // Convert to angles in the full range [0,2pi]
+
+      double ThetaSB = (sThetaSB>0.0) ? acos(cThetaSB) : -acos(cThetaSB);
+      if (ThetaSB < 0)               ThetaSB += TMath::TwoPi();
+      if (ThetaSB >= TMath::TwoPi()) ThetaSB -= TMath::TwoPi();
+
+      double ThetaSA = (sThetaSA>0.0) ? acos(cThetaSA) : -acos(cThetaSA);
+      if (ThetaSA < 0)               ThetaSA += TMath::TwoPi();
+      if (ThetaSA >= TMath::TwoPi()) ThetaSA -= TMath::TwoPi();
+
+      double ThetaRC = (sThetaRC>0.0) ? acos(cThetaRC) : -acos(cThetaRC);
+      if (ThetaRC < 0)               ThetaRC += TMath::TwoPi();
+      if (ThetaRC >= TMath::TwoPi()) ThetaRC -= TMath::TwoPi();
+
+      // The angle differences in the full range [0,2pi]
+
+      double ThetaSB_RC = ThetaSB - ThetaRC;
+      if (ThetaSB_RC < 0)               ThetaSB_RC += TMath::TwoPi();
+      if (ThetaSB_RC >= TMath::TwoPi()) ThetaSB_RC -= TMath::TwoPi();
+
+      double ThetaSA_RC = ThetaSA - ThetaRC;
+      if (ThetaSA_RC < 0)               ThetaSA_RC += TMath::TwoPi();
+      if (ThetaSA_RC >= TMath::TwoPi()) ThetaSA_RC -= TMath::TwoPi();
+
+      // collect angles to be histogrammed
+      content.phiCollB = ThetaSB_RC;
+      content.phiCollY = ThetaSA_RC;
+      content.phiBoerB = 0.0;
+      content.phiBoerY = 0.0;
+      content.spinB    = vecSpin3.first.Y();
+      content.spinY    = vecSpin3.second.Y();
+      content.pattern  = jet.pattern;
+      return;
+
+    }  // end 'Calc(Type::Jet&, Type::Vec4&, std::pair<Type::Vec4, Type::Vec4>&, SpinGeometry::Config&, Type::HistContent&)'
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a row of pairs
+    // ------------------------------------------------------------------------
+    /*! The spin planes of `spin` are shared by the whole row (see
+     *  `Kernel::GetDiFFAnglesRow`), so this should only be used for
+     *  patterns with fixed spins. Null spins are drawn for each pair,
+     *  and so need `Calc`.
+     */
+    static void CalcRow(
+      const Type::Jet& jet,
+      const Type::Vec4& unitJet4,
+      const std::vector<Type::Vec4>& vecCst4,
+      const Kernel::CstView& view,
+      const std::size_t ia,
+      const SpinGeometry::Config& spin,
+      Type::HistContent* contents
+    ) {
+
+      // n.b. only the constituents are needed
+      (void) unitJet4;
+      (void) vecCst4;
+
+      // calculate angles for whole row
+      Kernel::GetDiFFAnglesRow(spin.planes, view, ia, contents);
+      for (std::size_t ib = 0; ib <= ia; ++ib) {
+        contents[ib].phiBoerB = 0.0;
+        contents[ib].phiBoerY = 0.0;
+        contents[ib].spinB    = spin.spins.first.Y();
+        contents[ib].spinY    = spin.spins.second.Y();
+        contents[ib].pattern  = jet.pattern;
+      }
+      return;
+
+    }  // end 'CalcRow(Type::Jet&, Type::Vec4&, std::vector<Type::Vec4>&, Kernel::CstView&, std::size_t, SpinGeometry::Config&, Type::HistContent*)'
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a pair slot across a batch of jets
+    // ------------------------------------------------------------------------
+    /*! Sets `contents[lane]` for pair (ia, ib) of each jet in the
+     *  batch, using the fixed spin of that jet's context.
+     */
+    static void CalcSlot(
+      const JetBatch& batch,
+      const std::size_t ia,
+      const std::size_t ib,
+      Type::HistContent* contents
+    ) {
+
+      for (std::size_t lane = 0; lane < batch.njet; ++lane) {
+        const SpinGeometry::Config& spin = *batch.contexts[lane].spin;
+        const std::size_t           pos_a = batch.At(ia, lane);
+        const std::size_t           pos_b = batch.At(ib, lane);
+        Kernel::GetDiFFAngles(
+          spin.planes,
+          Type::Vec3(batch.px[pos_a], batch.py[pos_a], batch.pz[pos_a]),
+          Type::Vec3(batch.px[pos_b], batch.py[pos_b], batch.pz[pos_b]),
+          contents[lane]
+        );
+        contents[lane].phiBoerB = 0.0;
+        contents[lane].phiBoerY = 0.0;
+        contents[lane].spinB    = spin.spins.first.Y();
+        contents[lane].spinY    = spin.spins.second.Y();
+        contents[lane].pattern  = batch.contexts[lane].jet.pattern;
+      }
+      return;
+
+    }  // end 'CalcSlot(JetBatch&, std::size_t x 2, Type::HistContent*)'
+
+  };  // end DiFFAngles
+
+
+
+  // ==========================================================================
+  //! Collins & Boer-Mulders angles
+  // ==========================================================================
+  /*! Fills the histogram content with the Collins (phiSpin - phiHadron)
+   *  and Boer-Mulders (phiSpin - 2 phiHadron) angles for each beam,
+   *  where phiHadron is the angle of the average constituent of the
+   *  pair about the jet axis.
+   */
+  struct CollinsAngles {
+
+    //! whether or not boer-mulders histograms are produced
+    static const bool DoBoerMulders = true;
+
+    //! whether or not the unit jet 4-momentum is used
+    static const bool UsesJetAxis = true;
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a pair
+    // ------------------------------------------------------------------------
+    static void Calc(
+      const Type::Jet& jet,
+      const Type::Vec4& unitJet4,
+      const std::pair<Type::Vec4, Type::Vec4>& vecCst4,
+      const SpinGeometry::Config& spin,
+      Type::HistContent& content
+    ) {
+
+      // get unit vector along average of cst 3-vectors
+      Type::Vec3 unitAvgCst3 = Tools::GetWeightedAvgVec(
+        vecCst4.first.Vect(),
+        vecCst4.second.Vect(),
+        true
+      );
+
+
+      // (0) get beam and spin directions
+      //   first  = blue beam/spin
+      //   second = yellow beam/spin
+      const std::pair<Type::Vec3, Type::Vec3>& vecBeam3 = spin.beams;
+      const std::pair<Type::Vec3, Type::Vec3>& vecSpin3 = spin.spins;
+
+      // (1) get vectors normal to the jet-beam plane
+      std::pair<Type::Vec3, Type::Vec3> normJetBeam3 = std::make_pair(
+        ( vecBeam3.first.Cross(unitJet4.Vect()) ).Unit(),
+        ( vecBeam3.second.Cross(unitJet4.Vect()) ).Unit()
+      );
+
+      // (2) get phiSpin: angles between the jet-beam plane and spin
+      //   - n.b. for spin pattern >= 4, the yellow spin is randomized
+      //   - angle between jet plane and spin
+
+      // get vectors normal to the spin-beam plane
+      const std::pair<Type::Vec3, Type::Vec3>& normJetSpin = spin.unitNorms;
+
+      double phiSpinBlue = atan2( normJetBeam3.first.Cross(normJetSpin.first).Mag(), normJetBeam3.first.Dot(normJetSpin.first) );
+      double phiSpinYell = atan2( normJetBeam3.second.Cross(normJetSpin.second).Mag(), normJetBeam3.second.Dot(normJetSpin.second) );
+
+      // define the zero of phiSpin as the jet-beam plane and the sense of rotation
+      // the result will be in [0,2pi]
+
+      if(normJetBeam3.first.Dot(vecSpin3.first)<0.0) phiSpinBlue = TMath::TwoPi() - phiSpinBlue;
+      if(normJetBeam3.second.Dot(vecSpin3.second)<0.0) phiSpinYell = TMath::TwoPi() - phiSpinYell;
+
+      // (3) get vector normal to hadron average-jet plane
+      Type::Vec3 normHadJet3 = ( unitJet4.Vect().Cross(unitAvgCst3) ).Unit();
+
+      // (4) get phiHadron: angle between the jet-beam plane and the
+      //   - angle between jet-hadron plane
+      //   - constrain to range [0,2pi)
+      double phiHadBlue = atan2( normJetBeam3.first.Cross(normHadJet3).Mag(), normJetBeam3.first.Dot(normHadJet3) );
+      double phiHadYell = atan2( normJetBeam3.second.Cross(normHadJet3).Mag(), normJetBeam3.second.Dot(normHadJet3) );
+
+      // define the zero of phiHad as the jet-beam plane and the sense of rotation
+      // the result will be in [0,2pi]
+
+      if(normJetBeam3.first.Dot(unitAvgCst3)<0.0) phiHadBlue = TMath::TwoPi() - phiHadBlue;
+      if(normJetBeam3.second.Dot(unitAvgCst3)<0.0) phiHadYell = TMath::TwoPi() - phiHadYell;
+
+      // (5) double phiHadron for boer-mulders,
+      //   - constrain to [0, 2pi)
+      double phiHadBlue2 = 2.0 * phiHadBlue;
+      double phiHadYell2 = 2.0 * phiHadYell;
+      if (phiHadBlue2 < 0)               phiHadBlue2 += TMath::TwoPi();
+      if (phiHadBlue2 >= TMath::TwoPi()) phiHadBlue2 -= TMath::TwoPi();
+      if (phiHadYell2 < 0)               phiHadYell2 += TMath::TwoPi();
+      if (phiHadYell2 >= TMath::TwoPi()) phiHadYell2 -= TMath::TwoPi();
+
+      // (6) now calculate phiColl: phiSpin - phiHadron,
+      //   - constrain to [0, 2pi)
+      double phiCollBlue = phiSpinBlue - phiHadBlue;
+      double phiCollYell = phiSpinYell - phiHadYell;
+      if (phiCollBlue < 0)               phiCollBlue += TMath::TwoPi();
+      if (phiCollBlue >= TMath::TwoPi()) phiCollBlue -= TMath::TwoPi();
+      if (phiCollYell < 0)               phiCollYell += TMath::TwoPi();
+      if (phiCollYell >= TMath::TwoPi()) phiCollYell -= TMath::TwoPi();
+
+      // (7) now calculate phiBoer: phiSpin - (2 * phiHadron),
+      double phiBoerBlue = phiSpinBlue - phiHadBlue2;
+      double phiBoerYell = phiSpinYell - phiHadYell2;
+
+      // (8) constrain phiBoerBlue to [0, 2pi)
+      if (phiBoerBlue < 0)               phiBoerBlue += TMath::TwoPi();
+      if (phiBoerBlue >= TMath::TwoPi()) phiBoerBlue -= TMath::TwoPi();
+
+      // (9) constrain to phiBoerYell to [0, 2pi)
+      if (phiBoerYell < 0)               phiBoerYell += TMath::TwoPi();
+      if (phiBoerYell >= TMath::TwoPi()) phiBoerYell -= TMath::TwoPi();
+
+      // collect angles to be histogrammed
+      content.phiCollB = phiCollBlue;
+      content.phiCollY = phiCollYell;
+      content.phiBoerB = phiBoerBlue;
+      content.phiBoerY = phiBoerYell;
+      content.spinB    = vecSpin3.first.Y();
+      content.spinY    = vecSpin3.second.Y();
+      content.pattern  = jet.pattern;
+      return;
+
+    }  // end 'Calc(Type::Jet&, Type::Vec4&, std::pair<Type::Vec4, Type::Vec4>&, SpinGeometry::Config&, Type::HistContent&)'
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a row of pairs
+    // ------------------------------------------------------------------------
+    /*! Every pair of the row uses `spin`, so this should only be
+     *  used for patterns with fixed spins.
+     */
+    static void CalcRow(
+      const Type::Jet& jet,
+      const Type::Vec4& unitJet4,
+      const std::vector<Type::Vec4>& vecCst4,
+      const Kernel::CstView& view,
+      const std::size_t ia,
+      const SpinGeometry::Config& spin,
+      Type::HistContent* contents
+    ) {
+
+      // n.b. no batched kernel yet, so just do each pair
+      (void) view;
+      for (std::size_t ib = 0; ib <= ia; ++ib) {
+        Calc(jet, unitJet4, std::make_pair(vecCst4[ia], vecCst4[ib]), spin, contents[ib]);
+      }
+      return;
+
+    }  // end 'CalcRow(Type::Jet&, Type::Vec4&, std::vector<Type::Vec4>&, Kernel::CstView&, std::size_t, SpinGeometry::Config&, Type::HistContent*)'
+
+    // ------------------------------------------------------------------------
+    //! Calculate angles for a pair slot across a batch of jets
+    // ------------------------------------------------------------------------
+    static void CalcSlot(
+      const JetBatch& batch,
+      const std::size_t ia,
+      const std::size_t ib,
+      Type::HistContent* contents
+    ) {
+
+      // n.b. no batched kernel yet, so just do each jet
+      for (std::size_t lane = 0; lane < batch.njet; ++lane) {
+        Calc(
+          batch.contexts[lane].jet,
+          batch.contexts[lane].unitJet4,
+          std::make_pair(batch.vecs[batch.At(ia, lane)], batch.vecs[batch.At(ib, lane)]),
+          *batch.contexts[lane].spin,
+          contents[lane]
+        );
+      }
+      return;
+
+    }  // end 'CalcSlot(JetBatch&, std::size_t x 2, Type::HistContent*)'
+
+  };  // end CollinsAngles
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
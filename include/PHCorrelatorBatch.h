@@ -0,0 +1,130 @@
+/// ============================================================================
+/*! \file    PHCorrelatorBatch.h
+ *  \authors Derek Anderson
+ *  \date    10.16.2026
+ *
+ *  Jet-major batch of equal-multiplicity jets for
+ *  ENC calculations across several jets at once.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORBATCH_H
+#define PHCORRELATORBATCH_H
+
+// c++ utilities
+#include <vector>
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorJetContext.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorSpinGeometry.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Batch of jets with the same no. of constituents
+  // ==========================================================================
+  /*! Low-multiplicity jets have too few pairs for a row kernel to fill
+   *  its lanes, so instead up to `nlane` jets with `ncst` constituents
+   *  each are queued and pair slot (A, B) is processed for all of them
+   *  at once. Constituent quantities are stored jet-major, i.e. entry
+   *  (icst, lane) is at `(icst * nlane) + lane`, so that each slot
+   *  kernel (e.g. `Kernel::GetCstDistSlot`) reads contiguous lanes.
+   *
+   *  Weights of scheme `isch` are at `((isch * ncst) + icst) * nlane +
+   *  lane`. Spin configurations are taken from each jet's context, so
+   *  only jets with fixed spins can be batched. Arrays are sized for
+   *  a full batch, so unused lanes can be safely read.
+   */
+  struct JetBatch {
+
+    // data members (layout)
+    std::size_t ncst;
+    std::size_t nlane;
+    std::size_t nscheme;
+    std::size_t njet;
+
+    // data members (per jet)
+    std::vector<JetContext> contexts;
+    std::vector<double>     evtWeights;
+
+    // data members (per constituent, jet-major)
+    std::vector<double>     eta;
+    std::vector<double>     phi;
+    std::vector<double>     px;
+    std::vector<double>     py;
+    std::vector<double>     pz;
+    std::vector<Type::Vec4> vecs;
+    std::vector<double>     weights;
+
+    //! get position of (cst, lane)
+    std::size_t At(const std::size_t icst, const std::size_t lane) const {
+      return (icst * nlane) + lane;
+    }
+
+    //! check if batch is full/empty
+    bool Full()  const {return njet >= nlane;}
+    bool Empty() const {return njet == 0;}
+
+    //! empty batch (but keep memory)
+    void Clear() {njet = 0;}
+
+    //! set layout and allocate a full batch
+    void Reset(const std::size_t ncstArg, const std::size_t nlaneArg, const std::size_t nschemeArg) {
+      ncst    = ncstArg;
+      nlane   = nlaneArg;
+      nscheme = nschemeArg;
+      njet    = 0;
+      contexts.resize(nlane);
+      evtWeights.resize(nlane);
+      eta.assign(ncst * nlane, 0.);
+      phi.assign(ncst * nlane, 0.);
+      px.assign(ncst * nlane, 0.);
+      py.assign(ncst * nlane, 0.);
+      pz.assign(ncst * nlane, 0.);
+      vecs.resize(ncst * nlane);
+      weights.assign(nscheme * ncst * nlane, 0.);
+    }
+
+    //! add a jet from a loaded constituent view, vectors and weights
+    //!   - n.b. weights are stored scheme-by-scheme as in `LoadCsts`,
+    //!     i.e. weight of (isch, icst) at `csts_weights[(isch * ncst) + icst]`
+    std::size_t Add(
+      const JetContext& context,
+      const double evt_weight,
+      const Kernel::CstView& view,
+      const std::vector<Type::Vec4>& csts,
+      const double* cst_weights
+    ) {
+      const std::size_t lane = njet++;
+      contexts[lane]   = context;
+      evtWeights[lane] = evt_weight;
+      for (std::size_t icst = 0; icst < ncst; ++icst) {
+        const std::size_t pos = At(icst, lane);
+        eta[pos]  = view.eta[icst];
+        phi[pos]  = view.phi[icst];
+        px[pos]   = view.px[icst];
+        py[pos]   = view.py[icst];
+        pz[pos]   = view.pz[icst];
+        vecs[pos] = csts[icst];
+        for (std::size_t isch = 0; isch < nscheme; ++isch) {
+          weights[(isch * ncst * nlane) + pos] = cst_weights[(isch * ncst) + icst];
+        }
+      }
+      return lane;
+    }
+
+    //! default ctor/dtor
+    JetBatch() : ncst(0), nlane(0), nscheme(0), njet(0) {};
+    ~JetBatch() {};
+
+  };  // end JetBatch
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -11,6 +11,7 @@
 #define PHCORRELATORBINNING_H
 
 // c++ utilities
+#include <algorithm>
 #include <string>
 #include <vector>
 // analysis components
@@ -26,6 +27,11 @@ namespace PHEnergyCorrelator {
   // ==========================================================================
   /*! A small class to consolidate data
    *  for defining histogram bins.
+   *
+   *  Binnings defined by uniform parameters
+   *  remember their axis type so that bins
+   *  can be found arithmetically rather than
+   *  by a binary search.
    */ 
   class Binning {
 
@@ -37,6 +43,12 @@ namespace PHEnergyCorrelator {
       std::size_t         m_num;
       std::vector<double> m_bins;
 
+      // data members (for arithmetic bin lookup)
+      bool                m_uniform;
+      Type::Axis          m_axis;
+      double              m_start_use;
+      double              m_step_inv;
+
     public:
 
       // ----------------------------------------------------------------------
@@ -51,10 +63,56 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       std::vector<double> GetBins() const {return m_bins;}
 
+      // ----------------------------------------------------------------------
+      //! Axis getters
+      // ----------------------------------------------------------------------
+      bool       GetIsUniform() const {return m_uniform;}
+      Type::Axis GetAxis()      const {return m_axis;}
+
+      // ----------------------------------------------------------------------
+      //! Find bin containing a value
+      // ----------------------------------------------------------------------
+      /*! Follows the TAxis convention: returns 0 for underflow, the
+       *  no. of bins + 1 for overflow (incl. NaN), and otherwise bin
+       *  i such that edge[i - 1] <= x < edge[i].
+       *
+       *  For uniform (or log-uniform) binnings, the bin is first
+       *  estimated from the (log) offset times the inverse step, and
+       *  then corrected against the stored edges so that values on
+       *  or near an edge land exactly where a binary search would
+       *  put them.
+       */
+      std::size_t FindBin(const double x) const {
+
+        // handle under/overflow
+        if (x < m_bins.front())    return 0;
+        if (!(x < m_bins.back()))  return m_num + 1;
+
+        // if edges are arbitrary, do a binary search
+        if (!m_uniform) {
+          return std::upper_bound(m_bins.begin(), m_bins.end(), x) - m_bins.begin();
+        }
+
+        // otherwise estimate bin arithmetically
+        const double use = (m_axis == Type::Log) ? Tools::Log(x) : x;
+        const double est = (use - m_start_use) * m_step_inv;
+
+        std::size_t bin = 1;
+        if (est > 0.) {
+          bin = std::min((std::size_t) est + 1, m_num);
+        }
+
+        // and correct against edges
+        while ((bin > 1) && (x < m_bins[bin - 1])) --bin;
+        while ((bin < m_num) && !(x < m_bins[bin])) ++bin;
+        return bin;
+
+      }  // end 'FindBin(double)'
+
       // ----------------------------------------------------------------------
       //! default ctor/dtor
       // ----------------------------------------------------------------------
-      Binning()  {};
+      Binning() : m_start(0.), m_stop(0.), m_num(0), m_uniform(false), m_axis(Type::Norm), m_start_use(0.), m_step_inv(0.) {};
       ~Binning() {};
 
       // ----------------------------------------------------------------------
@@ -72,6 +130,13 @@ namespace PHEnergyCorrelator {
         m_stop  = stop;
         m_bins  = Tools::GetBinEdges(m_num, m_start, m_stop, axis);
 
+        // set parameters for arithmetic lookup
+        //   - n.b. mirrors step in Tools::GetBinEdges
+        m_uniform   = true;
+        m_axis      = axis;
+        m_start_use = (axis == Type::Log) ? Tools::Log(start) : start;
+        m_step_inv  = num / (((axis == Type::Log) ? Tools::Log(stop) : stop) - m_start_use);
+
       }  // end ctor(uint32_t, double, double, Type::Axis)
 
       // ----------------------------------------------------------------------
@@ -79,10 +144,14 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       Binning(const std::vector<double> edges) {
 
-        m_bins  = edges;
-        m_num   = edges.size() - 1;
-        m_start = edges.front();
-        m_stop  = edges.back();
+        m_bins      = edges;
+        m_num       = edges.size() - 1;
+        m_start     = edges.front();
+        m_stop      = edges.back();
+        m_uniform   = false;
+        m_axis      = Type::Norm;
+        m_start_use = m_start;
+        m_step_inv  = 0.;
 
       }  // end ctor(std::vector<double>)
 
@@ -13,18 +13,26 @@
 
 // c++ utilities
 #include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <stdint.h>
 #include <string>
 #include <utility>
 #include <vector>
 // root libraries
-#include <TLorentzVector.h>
 #include <TMath.h>
-#include <TVector3.h>
 // analysis componenets
 #include "PHCorrelatorAnaTools.h"
 #include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorAngles.h"
+#include "PHCorrelatorBatch.h"
 #include "PHCorrelatorHistManager.h"
+#include "PHCorrelatorJetContext.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorPairCache.h"
+#include "PHCorrelatorSpinGeometry.h"
+#include "PHCorrelatorVectors.h"
+#include "PHCorrelatorWeights.h"
 
 
 
@@ -33,75 +41,162 @@ namespace PHEnergyCorrelator {
   // ==========================================================================
   //! ENC Calculator
   // ==========================================================================
-  class Calculator {
+  /*! The first template parameter selects which spin-dependent angles
+   *  are calculated (see PHCorrelatorAngles.h), and thus which
+   *  histograms get booked. Use the `Calculator` (dihadron FF) or the
+   *  `CollinsCalculator` (Collins/Boer-Mulders) typedefs below.
+   *
+   *  The second selects how constituent weights are evaluated (see
+   *  PHCorrelatorWeights.h). By default, the weight type and power
+   *  are picked at runtime; `FixedWeight<W, P>` resolves them at
+   *  compile time instead.
+   */
+  template <typename Angles, typename Weights = RuntimeWeight> class BasicCalculator {
 
     private:
 
       // data members (calc options)
       double       m_weight_power;
       Type::Weight m_weight_type;
+      Kernel::ISA  m_isa;
 
       // data members (bins)
       std::vector< std::pair<float, float> > m_ptjet_bins;
       std::vector< std::pair<float, float> > m_cfjet_bins;
       std::vector< std::pair<float, float> > m_chrg_bins;
 
+      // data members (leading-hadron options)
+      double (*m_lambda_score)(const Type::Cst&);
+
       // data member (hist manager)
       HistManager m_manager;
 
-      // ---------------------------------------------------------------------=
-      //! Get weight of a constituent
+      // data members (additional weight schemes)
+      //   - n.b. the main manager holds the (m_weight_type,
+      //     m_weight_power) scheme, and each additional scheme
+      //     gets its own manager
+      std::vector<Type::WeightScheme> m_schemes;
+      std::vector<HistManager>        m_scheme_managers;
+
+      // data member (pair cache)
+      PairCache* m_cache;
+
+      // data members (spin geometry & random key)
+      SpinGeometry m_spin;
+      uint64_t     m_event;
+      uint64_t     m_jet;
+
+      // data members (per-jet workspace)
+      Kernel::CstView                m_view;
+      std::vector<Type::Vec4>        m_vecs;
+      std::vector<double>            m_weights;
+      std::vector<double>            m_cst_weights;
+      std::vector<double>            m_dists;
+      std::vector<Type::HistContent> m_angles;
+      Type::HistContent              m_pair_angles;
+      std::vector<Type::HistContent> m_shapes;
+      std::vector< std::pair<double, std::size_t> > m_pairs;
+      std::vector<std::size_t>       m_ranks;
+      std::vector<std::size_t>       m_inside;
+      std::vector<double>            m_esp;
+      std::vector< std::vector<std::size_t> > m_cliques;
+      bool                           m_enc_fast;
+      JetContext                     m_context;
+
+      // data members (jet batches)
+      //   - n.b. batch n holds queued jets with n selected cst.s
+      std::vector<JetBatch> m_batches;
+      std::size_t           m_batch_lanes;
+      std::size_t           m_batch_max;
+
+      // ----------------------------------------------------------------------
+      //! Get weight norms of a jet for every scheme
+      // ----------------------------------------------------------------------
+      /*! Weight denominators only depend on the jet, so they're
+       *  calculated once per jet and reused for every constituent.
+       */
+      void GetJetNorms(const Type::Vec4& jet, std::vector<double>& norms) const {
+
+        norms.resize( GetNSchemes() );
+        norms[0] = Weights::GetNorm(jet, m_weight_type, m_weight_power);
+        for (std::size_t isch = 0; isch < m_schemes.size(); ++isch) {
+          norms[isch + 1] = RuntimeWeight::GetNorm(jet, m_schemes[isch].type, m_schemes[isch].power);
+        }
+        return;
+
+      }  // end 'GetJetNorms(Type::Vec4&, std::vector<double>&)'
+
+      // ----------------------------------------------------------------------
+      //! Get weights of a constituent for every scheme
       // ----------------------------------------------------------------------
-      double GetCstWeight(TLorentzVector& cst, TLorentzVector& jet) {
+      /*! Sets `weights[ischeme * stride]` for each scheme, where the
+       *  main scheme is 0 (see `GetNSchemes`), given the jet norms of
+       *  each scheme (see `GetJetNorms`).
+       */
+      void GetCstWeights(
+        const Type::Vec4& cst,
+        const std::vector<double>& norms,
+        double* weights,
+        const std::size_t stride
+      ) const {
+
+        weights[0] = Weights::Get(cst, norms[0], m_weight_type, m_weight_power);
+        for (std::size_t isch = 0; isch < m_schemes.size(); ++isch) {
+          weights[(isch + 1) * stride] = RuntimeWeight::Get(cst, norms[isch + 1], m_schemes[isch].type, m_schemes[isch].power);
+        }
+        return;
+
+      }  // end 'GetCstWeights(Type::Vec4&, std::vector<double>&, double*, std::size_t)'
 
-        // grab relevant cst & jet values
-        double numer = 1.0;
-        double denom = 1.0;
-        switch (m_weight_type) {
+      // ----------------------------------------------------------------------
+      //! Get key of a pair of constituents
+      // ----------------------------------------------------------------------
+      /*! Position of pair (A, B) in the jet's pair triangle (see
+       *  `Kernel::GetTriangleOffset`), regardless of order.
+       */
+      static uint64_t GetPairKey(const std::size_t icst_a, const std::size_t icst_b) {
 
-          case Type::E:
-            numer = cst.E();
-            denom = jet.E();
-            break;
+        return Kernel::GetTriangleOffset( std::max(icst_a, icst_b) ) + std::min(icst_a, icst_b);
 
-          case Type::Et:
-            numer = cst.Et();
-            denom = jet.Et();
-            break;
+      }  // end 'GetPairKey(std::size_t, std::size_t)'
 
-          case Type::Pt:
-            numer = cst.Pt();
-            denom = jet.Pt();
-            break;
+      // ----------------------------------------------------------------------
+      //! Get beam and spin vectors for a pair of a jet
+      // ----------------------------------------------------------------------
+      /*! Returns the configuration cached in the jet context if the
+       *  jet's pattern has fixed spins, and otherwise draws one for
+       *  key (event, jet, `pair`) (see `SpinGeometry::Get`), where
+       *  `pair` is the pair's key (see `GetPairKey`). So every path
+       *  (pair-by-pair, per jet, ...) draws the same spin for the
+       *  same pair.
+       */
+      const SpinGeometry::Config& GetSpin(const JetContext& context, const uint64_t pair) {
 
-          default:
-            numer = cst.Pt();
-            denom = jet.Pt();
-            break;
+        return context.spin ? *context.spin : m_spin.Get(context.jet.pattern, m_event, m_jet, pair);
 
-        }  // end switch
+      }  // end 'GetSpin(JetContext&, uint64_t)'
 
-        // raise cst, jet values to specified value (defualt is 1.0)
-        numer = pow(numer, m_weight_power);
-        denom = pow(denom, m_weight_power);
+      // ----------------------------------------------------------------------
+      //! Get manager of a weight scheme
+      // ----------------------------------------------------------------------
+      HistManager& GetSchemeManager(const std::size_t ischeme) {
 
-        // calculate weight and exit
-        const double weight = numer / denom;
-        return weight;
+        return (ischeme == 0) ? m_manager : m_scheme_managers[ischeme - 1];
 
-      }  // end 'GetCstWeight(TLorentzVector&, TLorentzVector&)'
+      }  // end 'GetSchemeManager(std::size_t)'
 
       // ----------------------------------------------------------------------
       //! Get hist index/indices
       // ----------------------------------------------------------------------
-      /*! Returns a vector of indices of histograms to be filled. If not doing
-       *  spin sorting, vector will only have FOUR entries, which are
+      /*! Returns a list of indices of histograms to be filled (see
+       *  `Type::IndexList`, so nothing is allocated). If not doing
+       *  spin sorting, list will only have FOUR entries, which are
        *    [0] = integrated pt, charge (+cf bin)
        *    [1] = pt bin, integrated charge (+cf bin)
        *    [2] = charge bin, integrated pt (+cf bin)
        *    [3] = pt bin, charge bin (+cf bin)
        *
-       *  If doing spin sorting, the vector will have either 4, 8, or 16
+       *  If doing spin sorting, the list will have either 4, 8, or 16
        *  entries.
        *    - `size() == 16`: pp case; entries correspond to spin-integrated,
        *       blue-only, yellow-only, and blue-and-yellow indices.
@@ -110,13 +205,17 @@ namespace PHEnergyCorrelator {
        *    - `size() == 4`: an unexpected spin pattern was provided, only
        *       spin-integrated case returned.
        *
-       *  The order of the vector of indices will always be
+       *  The order of the list of indices will always be
        *    [0 - 3]   = spin integrated
        *    [4 - 7]   = blue beam index
        *    [8 - 11]  = yellow beam index
        *    [12 - 15] = blue and yellow index
+       *
+       *  If only filling the finest bins, the list will have only ONE
+       *  entry: binned pt, binned charge (+cf bin), and the most
+       *  differential spin bin available for the jet's pattern.
        */
-      std::vector<Type::HistIndex> GetHistIndices(const Type::Jet& jet) {
+      Type::IndexList GetHistIndices(const Type::Jet& jet) {
 
         // for pt and cf, index will correspond to what bin
         // the jet falls in PLUS integrated pt/charge bin
@@ -151,8 +250,9 @@ namespace PHEnergyCorrelator {
         }
 
         // By default, only add spin-integrated bin
-        std::vector<std::size_t> spin_indices;
-        spin_indices.push_back( HistManager::Int );
+        std::size_t spin_indices[4];
+        std::size_t nspin = 0;
+        spin_indices[nspin++] = HistManager::Int;
 
         // if needed, determine spin bins
         if (m_manager.GetDoSpinBins()) {
@@ -160,40 +260,40 @@ namespace PHEnergyCorrelator {
 
               // blue up, yellow up (pp)
               case Type::PPBUYU:
-                spin_indices.push_back( HistManager::BU );
-                spin_indices.push_back( HistManager::YU );
-                spin_indices.push_back( HistManager::BUYU );
+                spin_indices[nspin++] = HistManager::BU;
+                spin_indices[nspin++] = HistManager::YU;
+                spin_indices[nspin++] = HistManager::BUYU;
                 break;
 
               // blue down, yellow up (pp)
               case Type::PPBDYU:
-                spin_indices.push_back( HistManager::BD );
-                spin_indices.push_back( HistManager::YU );
-                spin_indices.push_back( HistManager::BDYU );
+                spin_indices[nspin++] = HistManager::BD;
+                spin_indices[nspin++] = HistManager::YU;
+                spin_indices[nspin++] = HistManager::BDYU;
                 break;
 
               // blue up, yellow down (pp)
               case Type::PPBUYD:
-                spin_indices.push_back( HistManager::BU );
-                spin_indices.push_back( HistManager::YD );
-                spin_indices.push_back( HistManager::BUYD );
+                spin_indices[nspin++] = HistManager::BU;
+                spin_indices[nspin++] = HistManager::YD;
+                spin_indices[nspin++] = HistManager::BUYD;
                 break;
 
               // blue down, yellow down (pp)
               case Type::PPBDYD:
-                spin_indices.push_back( HistManager::BD );
-                spin_indices.push_back( HistManager::YD );
-                spin_indices.push_back( HistManager::BDYD );
+                spin_indices[nspin++] = HistManager::BD;
+                spin_indices[nspin++] = HistManager::YD;
+                spin_indices[nspin++] = HistManager::BDYD;
                 break;
 
               // blue up (pAu)
               case Type::PABU:
-                spin_indices.push_back( HistManager::BU );
+                spin_indices[nspin++] = HistManager::BU;
                 break;
 
               // blue down (pAu)
               case Type::PABD:
-                spin_indices.push_back( HistManager::BD );
+                spin_indices[nspin++] = HistManager::BD;
                 break;
 
               // by default, only add integrated
@@ -204,11 +304,26 @@ namespace PHEnergyCorrelator {
         }
 
         // now assemble list of indices to fill
-        std::vector<Type::HistIndex> indices;
-        for (std::size_t isp = 0; isp < spin_indices.size(); ++isp) {
+        Type::IndexList indices;
+
+        // if only filling finest bins, the last spin index
+        // is the most differential one
+        if (m_manager.GetDoFinestOnly()) {
+          indices.Add(
+            Type::HistIndex(
+              base_index.pt,
+              base_index.cf,
+              base_index.chrg,
+              spin_indices[nspin - 1]
+            )
+          );
+          return indices;
+        }
+
+        for (std::size_t isp = 0; isp < nspin; ++isp) {
 
           // integrated everything (except cf)
-          indices.push_back(
+          indices.Add(
             Type::HistIndex(
               m_ptjet_bins.size(),
               base_index.cf,
@@ -218,7 +333,7 @@ namespace PHEnergyCorrelator {
           );
 
           // binned pt, integrated charge
-          indices.push_back(
+          indices.Add(
             Type::HistIndex(
               base_index.pt,
               base_index.cf,
@@ -228,7 +343,7 @@ namespace PHEnergyCorrelator {
           );
 
           // binned charge, integrated pt
-          indices.push_back(
+          indices.Add(
             Type::HistIndex(
               m_ptjet_bins.size(),
               base_index.cf,
@@ -238,7 +353,7 @@ namespace PHEnergyCorrelator {
           );
 
           // binned everything
-          indices.push_back(
+          indices.Add(
             Type::HistIndex(
               base_index.pt,
               base_index.cf,
@@ -251,25 +366,326 @@ namespace PHEnergyCorrelator {
 
       }  // end 'GetHistIndices(Type::Jet&)'
 
-    public:
 
-      /* TODO
-       *   - DoE3CCalc(jet, {cst, cst, cst})
-       *   - DoLECCalc(jet, {lambda, cst})
-       *   - FindLambda({cst...})
+      // ----------------------------------------------------------------------
+      //! Load constituents of a jet into per-jet workspace
+      // ----------------------------------------------------------------------
+      /*! Calculates the 4-momentum and weights of each selected
+       *  constituent, and adds it to the structure-of-arrays view
+       *  used by the kernels. Weights are stored scheme-by-scheme,
+       *  i.e. `m_weights[(ischeme * ncst) + icst]`.
+       */
+      void LoadCsts(
+        const JetContext& context,
+        const std::vector<Type::Cst>& csts,
+        bool (*select)(const Type::Cst&)
+      ) {
+
+        m_vecs.clear();
+        m_view.Clear();
+        for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+
+          // skip cst.s which aren't selected
+          if (select && !select(csts[icst])) continue;
+
+          m_vecs.push_back( Tools::GetCstVec(csts[icst], context.jet.pt, false) );
+          m_view.Add( csts[icst], m_vecs.back().Vect() );
+        }
+
+        // then get weights for each scheme
+        const std::size_t ncst = m_vecs.size();
+        m_weights.resize( GetNSchemes() * ncst );
+        for (std::size_t icst = 0; icst < ncst; ++icst) {
+          m_weights[icst] = Weights::Get(m_vecs[icst], context.norms[0], m_weight_type, m_weight_power);
+        }
+        for (std::size_t isch = 0; isch < m_schemes.size(); ++isch) {
+          double* weights = &m_weights[(isch + 1) * ncst];
+          for (std::size_t icst = 0; icst < ncst; ++icst) {
+            weights[icst] = RuntimeWeight::Get(m_vecs[icst], context.norms[isch + 1], m_schemes[isch].type, m_schemes[isch].power);
+          }
+        }
+        return;
+
+      }  // end 'LoadCsts(JetContext&, std::vector<Type::Cst>&, bool (*)(Type::Cst&))'
+
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation for a pair of pre-processed constituents
+      // ----------------------------------------------------------------------
+      /*! Workhorse for `CalcEEC` and `CalcEECJet`. Everything that only
+       *  depends on the jet (see `JetContext`) or on a single constituent
+       *  (4-momenta, weights) is expected to have been calculated already
+       *  by the caller, as is the distance between the constituents
+       *  (R_{L}).
+       *
+       *  Constituent weights of scheme `ischeme` are at `weights_a[ischeme
+       *  * stride]` and `weights_b[ischeme * stride]`; everything else is
+       *  only calculated once and shared by all schemes.
+       *
+       *  If spin-sorted histograms are filled, spin-dependent angles
+       *  are copied from `angles`, which must then be provided. If a
+       *  pair cache is set, the pair is recorded as (`icst_a`,
+       *  `icst_b`) of the jet being recorded.
+       */
+      void DoEECCalc(
+        const JetContext& context,
+        const double dist,
+        const double* weights_a,
+        const double* weights_b,
+        const std::size_t stride,
+        const double evt_weight,
+        const Type::HistContent* angles = NULL,
+        const std::size_t icst_a = 0,
+        const std::size_t icst_b = 1
+      ) {
+
+        // calculate eec quantities -------------------------------------------
+
+        // calculate overall EEC weight
+        const double weight = weights_a[0] * weights_b[0] * evt_weight;
+
+        // fill histograms ---------------------------------------------------=
+
+        // fill histograms if needed
+        if (m_manager.GetDoEECHists()) {
+
+          // collect quantities to be histogrammed
+          //   - n.b. angles are only needed if spin-sorted
+          //     histograms are filled
+          Type::HistContent content(weight, dist);
+          if (m_manager.GetDoSpinBins()) {
+            assert(angles);
+            content.phiCollB = angles -> phiCollB;
+            content.phiCollY = angles -> phiCollY;
+            content.phiBoerB = angles -> phiBoerB;
+            content.phiBoerY = angles -> phiBoerY;
+            content.spinB    = angles -> spinB;
+            content.spinY    = angles -> spinY;
+            content.pattern  = angles -> pattern;
+          }
+
+          // fill histograms for each index
+          //   - n.b. indices are ordered spin-integrated,
+          //     blue, yellow, and then blue and yellow
+          m_manager.FillEECHists(context.indices, content);
+
+          // record pair if needed
+          if (m_cache) {
+            uint32_t cells[PairCache::NCells];
+            m_manager.FindEECCells(content, cells);
+            m_cache -> AddPair(icst_a, icst_b, cells);
+          }
+
+          // then repeat for other weight schemes
+          for (std::size_t isch = 1; isch < GetNSchemes(); ++isch) {
+            content.weight = weights_a[isch * stride] * weights_b[isch * stride] * evt_weight;
+            m_scheme_managers[isch - 1].FillEECHists(context.indices, content);
+          }
+        }  // end hist filing
+        return;
+
+      }  // end 'DoEECCalc(JetContext&, double, ...)'
+
+      // ----------------------------------------------------------------------
+      //! Start recording a jet in the pair cache
+      // ----------------------------------------------------------------------
+      void BeginCachedJet(
+        const JetContext& context,
+        const std::vector<Type::Vec4>& vecCsts4,
+        const double evt_weight
+      ) {
+
+        m_cache -> BeginJet(m_event, m_jet, context.vecJet4, evt_weight);
+        for (std::size_t icst = 0; icst < vecCsts4.size(); ++icst) {
+          m_cache -> AddCst( vecCsts4[icst] );
+        }
+        for (std::size_t idx = 0; idx < context.indices.Size(); ++idx) {
+          m_cache -> AddIndex( m_manager.GetFlatIndex(context.indices[idx]) );
+        }
+        return;
+
+      }  // end 'BeginCachedJet(JetContext&, std::vector<Type::Vec4>&, double)'
+
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation over all pairs of a batch of jets
+      // ----------------------------------------------------------------------
+      /*! Pair slots (A, B <= A) are processed one at a time for every
+       *  jet in the batch: distances with a slot kernel (see
+       *  `Kernel::GetCstDistSlot`), angles (if needed) with the angle
+       *  policy's `CalcSlot`, then each jet's pair is filled as in
+       *  `CalcEECJet`. Empties the batch.
        */
+      void DoEECBatch(JetBatch& batch) {
+
+        const bool do_angles = m_manager.GetDoEECHists() && m_manager.GetDoSpinBins();
+        const std::size_t stride = batch.ncst * batch.nlane;
+
+        m_dists.resize( batch.nlane );
+        m_angles.resize( batch.nlane );
+        for (std::size_t ia = 0; ia < batch.ncst; ++ia) {
+          for (std::size_t ib = 0; ib <= ia; ++ib) {
+
+            // get distances (and angles) for this slot of every jet
+            Kernel::GetCstDistSlot(
+              &batch.eta[batch.At(ia, 0)],
+              &batch.phi[batch.At(ia, 0)],
+              &batch.eta[batch.At(ib, 0)],
+              &batch.phi[batch.At(ib, 0)],
+              batch.njet,
+              &m_dists[0],
+              m_isa
+            );
+            if (do_angles) {
+              Angles::CalcSlot(batch, ia, ib, &m_angles[0]);
+            }
+
+            // then fill each jet's pair
+            for (std::size_t lane = 0; lane < batch.njet; ++lane) {
+              DoEECCalc(
+                batch.contexts[lane],
+                m_dists[lane],
+                &batch.weights[batch.At(ia, lane)],
+                &batch.weights[batch.At(ib, lane)],
+                stride,
+                batch.evtWeights[lane],
+                do_angles ? &m_angles[lane] : NULL,
+                ia,
+                ib
+              );
+            }
+          }
+        }
+        batch.Clear();
+        return;
+
+      }  // end 'DoEECBatch(JetBatch&)'
+
+      // ----------------------------------------------------------------------
+      //! Do LEC calculation for a (lambda, constituent) pair
+      // ----------------------------------------------------------------------
+      /*! Workhorse for `CalcLECJet`. As with `DoEECCalc`, the distance
+       *  to the leading constituent and the weight of each scheme
+       *  (`cst_weights[ischeme]`) are expected to have been calculated
+       *  by the caller.
+       */
+      void DoLECCalc(
+        const JetContext& context,
+        const double dist,
+        const double* cst_weights,
+        const double evt_weight
+      ) {
+
+        // fill histograms if needed
+        if (m_manager.GetDoLECHists()) {
+          Type::HistContent content(cst_weights[0] * evt_weight, dist);
+          for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+            content.weight = cst_weights[isch] * evt_weight;
+            GetSchemeManager(isch).FillLECHists(context.indices, content);
+          }
+        }
+        return;
+
+      }  // end 'DoLECCalc(JetContext&, double, double*, double)'
+
+    public:
 
       // ----------------------------------------------------------------------
       //! Getters
       // ----------------------------------------------------------------------
       HistManager& GetManager() {return m_manager;}
+      std::size_t  GetNSchemes() const {return m_schemes.size() + 1;}
+      uint64_t     GetEvent()    const {return m_event;}
+      uint64_t     GetJet()      const {return m_jet;}
+      bool         GetCaching()  const {return m_cache != NULL;}
+      Kernel::ISA  GetKernelISA() const {return m_isa;}
+      std::size_t  GetBatchLanes() const {return m_batch_lanes;}
+      std::size_t  GetBatchMax()   const {return m_batch_max;}
+
+      // ----------------------------------------------------------------------
+      //! Get manager of a weight scheme
+      // ----------------------------------------------------------------------
+      /*! Scheme 0 is the main one (i.e. `GetManager()`), and the rest
+       *  are those added with `AddWeightScheme`, in order.
+       */
+      HistManager& GetManager(const std::size_t ischeme) {return GetSchemeManager(ischeme);}
 
       // ----------------------------------------------------------------------
       //! Setters
       // ----------------------------------------------------------------------
-      void SetWeightPower(const double power)       {m_weight_power = power;}
-      void SetWeightType(const Type::Weight weight) {m_weight_type  = weight;}
+      /*! N.B. with a `FixedWeight` policy, the weight type and power
+       *  can't be changed.
+       */
+      void SetWeightPower(const double power)       {m_weight_power = Weights::GetPower(power);}
+      void SetWeightType(const Type::Weight weight) {m_weight_type  = Weights::GetType(weight);}
       void SetHistTag(const std::string& tag)       {m_manager.SetHistTag(tag);}
+      void SetSeed(const uint64_t seed)             {m_spin.SetSeed(seed);}
+      void SetLambdaScore(double (*score)(const Type::Cst&)) {m_lambda_score = score;}
+
+      // ----------------------------------------------------------------------
+      //! Set instruction set of pair kernels
+      // ----------------------------------------------------------------------
+      /*! By default, the best one supported by the cpu is used (see
+       *  `Kernel::GetBestISA`). All kernels give identical results, so
+       *  this only changes speed, e.g. `Kernel::Scalar` turns off
+       *  explicit vectorization.
+       */
+      void SetKernelISA(const Kernel::ISA isa) {
+
+        // throw error if cpu doesn't support isa
+        if (!Kernel::IsSupported(isa)) {
+          assert(Kernel::IsSupported(isa));
+        }
+
+        m_isa = isa;
+        return;
+
+      }  // end 'SetKernelISA(Kernel::ISA)'
+
+      // ----------------------------------------------------------------------
+      //! Set pair cache
+      // ----------------------------------------------------------------------
+      /*! If set, every pair filled by `CalcEEC` or `CalcEECJet` is also
+       *  recorded in `cache` so that it can be replayed later with
+       *  `ReplayEEC`. Requires the flat backend. Pass NULL to stop
+       *  recording.
+       */
+      void SetPairCache(PairCache* cache) {
+
+        // throw error if not using flat backend
+        if (cache && !m_manager.UsesAccumulators()) {
+          assert(m_manager.UsesAccumulators());
+        }
+
+        m_cache = cache;
+        return;
+
+      }  // end 'SetPairCache(PairCache*)'
+
+      // ----------------------------------------------------------------------
+      //! Set event (and jet) being processed
+      // ----------------------------------------------------------------------
+      /*! Null spins (pAu and unknown patterns) are drawn from a
+       *  counter-based generator keyed by (seed, event, jet, pair),
+       *  so providing the event number makes them reproducible no
+       *  matter how events are split among jobs or threads.
+       *
+       *  `CalcEECJet` moves on to the next jet by itself. When
+       *  calling `CalcEEC` pair-by-pair, `SetJet` should be called
+       *  before each jet.
+       */
+      void SetEvent(const uint64_t event, const uint64_t jet = 0) {
+
+        m_event = event;
+        SetJet(jet);
+        return;
+
+      }  // end 'SetEvent(uint64_t, uint64_t)'
+
+      void SetJet(const uint64_t jet) {
+
+        m_jet = jet;
+        return;
+
+      }  // end 'SetJet(uint64_t)'
 
       // ----------------------------------------------------------------------
       //! Set jet pt bins
@@ -327,6 +743,116 @@ namespace PHEnergyCorrelator {
 
       }  // end 'SetDoSpinBins(bool)'
 
+      // ----------------------------------------------------------------------
+      //! Turn on/off filling only the finest bins
+      // ----------------------------------------------------------------------
+      /*! If on, each pair only fills the fully differential histogram
+       *  and the integrated ones are summed up in `End()`, or when
+       *  histograms are retrieved. Output is the same, but filling is
+       *  up to 16 times cheaper. N.B. with the ROOT backend, nothing
+       *  can be filled after histograms are first retrieved.
+       */
+      void SetDoFinestOnly(const bool finest) {
+
+        // and set corresponding flag in manager
+        m_manager.DoFinestOnly(finest);
+        return;
+
+      }  // end 'SetDoFinestOnly(bool)'
+
+      // ----------------------------------------------------------------------
+      //! Add a weight scheme
+      // ----------------------------------------------------------------------
+      /*! Each additional (weight type, power) scheme fills its own set
+       *  of histograms, tagged with `tag`, in the same pass as the main
+       *  one: geometry, angles and histogram indices are only calculated
+       *  once and shared by all schemes. Must be called before `Init`.
+       */
+      void AddWeightScheme(const Type::Weight weight, const double power, const std::string& tag) {
+
+        m_schemes.push_back( Type::WeightScheme(weight, power, tag) );
+        return;
+
+      }  // end 'AddWeightScheme(Type::Weight, double, std::string&)'
+
+      // ----------------------------------------------------------------------
+      //! Turn on projected N-point correlators
+      // ----------------------------------------------------------------------
+      /*! Books "ENCStat" histograms of order `order` (>= 2), which are
+       *  filled by `CalcENCJet`. Must be set before `Init`. See
+       *  `CalcENCJet` for what `fast` does, and for the multiplicities
+       *  the exact calculation is practical for when `order` >= 4.
+       */
+      void SetENCOrder(const std::size_t order, const bool fast = false) {
+
+        // throw error if order is too low
+        if (order < 2) {
+          assert(order >= 2);
+        }
+
+        m_enc_fast = fast;
+        m_manager.SetENCOrder(order);
+        m_manager.SetDoENCHists(true);
+        return;
+
+      }  // end 'SetENCOrder(std::size_t, bool)'
+
+      // ----------------------------------------------------------------------
+      //! Set histogram backend
+      // ----------------------------------------------------------------------
+      /*! With `Type::Flat`, histogram contents are accumulated in flat
+       *  arrays and only copied into ROOT histograms when they're saved
+       *  (or retrieved). With `Type::Atomic`, those arrays are shared
+       *  by the calculator and all of its clones (see `Clone`) and
+       *  filled with atomic adds, so many threads can fill 1 copy of
+       *  the histograms. Must be set before `Init`.
+       */
+      void SetHistBackend(const Type::Backend backend) {
+
+        m_manager.SetBackend(backend);
+        return;
+
+      }  // end 'SetHistBackend(Type::Backend)'
+
+      // ----------------------------------------------------------------------
+      //! Set no. of stripes of hot histograms
+      // ----------------------------------------------------------------------
+      /*! With `Type::Atomic`, histograms which every pair fills (i.e.
+       *  those integrated over pt, charge and spin) get `nstripes`
+       *  copies so that threads don't all contend for the same cache
+       *  lines; copies are summed when the histograms are saved. Should
+       *  be ~ the no. of threads. Must be set before `Init`.
+       */
+      void SetHistStripes(const std::size_t nstripes) {
+
+        m_manager.SetNStripes(nstripes);
+        return;
+
+      }  // end 'SetHistStripes(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Set size of jet batches
+      // ----------------------------------------------------------------------
+      /*! `BatchEECJet` queues up to `nlanes` jets of the same
+       *  multiplicity before processing them together. Only jets with
+       *  at most `max_cst` (selected) constituents are batched.
+       *
+       *  Batching is off (1 lane) by default: with 2 to 8 cst.s per
+       *  jet, batches of 8 jets measured within a few percent of
+       *  `CalcEECJet`, faster or slower depending on the multiplicity
+       *  (see test/performance/BatchedJetTest.C). So it should only be
+       *  turned on if it's measured to be faster for a given sample.
+       */
+      void SetBatchSize(const std::size_t nlanes, const std::size_t max_cst = 8) {
+
+        FlushEECBatches();
+        m_batches.clear();
+        m_batch_lanes = nlanes;
+        m_batch_max   = max_cst;
+        return;
+
+      }  // end 'SetBatchSize(std::size_t, std::size_t)'
+
       // ----------------------------------------------------------------------
       //! Initialize calculator
       // ----------------------------------------------------------------------
@@ -337,290 +863,790 @@ namespace PHEnergyCorrelator {
         m_manager.SetDoE3CHists(do_e3c);
         m_manager.SetDoLECHists(do_lec);
 
+        // only book boer-mulders histograms if angles are calculated
+        m_manager.SetDoBoerHists(Angles::DoBoerMulders);
+
+        // copy configuration to managers of other weight schemes
+        m_scheme_managers.clear();
+        for (std::size_t isch = 0; isch < m_schemes.size(); ++isch) {
+          m_scheme_managers.push_back( m_manager );
+          m_scheme_managers.back().SetHistTag( m_schemes[isch].tag );
+        }
+
         // then generate necessary histograms
-        m_manager.GenerateHists();
+        for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+          GetSchemeManager(isch).GenerateHists();
+        }
+
+        // allocate scratch used by `CalcEEC` up front
+        m_context.norms.resize( GetNSchemes() );
+        m_cst_weights.resize( 2 * GetNSchemes() );
+        m_vecs.reserve(2);
         return;
 
       } // end 'Init(bool, bool, bool)'
 
+      // ----------------------------------------------------------------------
+      //! Reserve per-jet workspace
+      // ----------------------------------------------------------------------
+      /*! Workspace grows to fit the largest jet seen so far and is
+       *  then reused, so calculations only allocate while jets keep
+       *  getting bigger. Reserving space for jets of up to `max_cst`
+       *  (selected) constituents up front avoids even that. Should be
+       *  called after `Init`.
+       */
+      void ReserveJet(const std::size_t max_cst) {
+
+        m_view.Reserve(max_cst);
+        m_vecs.reserve(max_cst);
+        m_weights.reserve( GetNSchemes() * max_cst );
+        m_dists.reserve( Kernel::GetTriangleOffset(max_cst) );
+        m_angles.reserve(max_cst);
+        return;
+
+      }  // end 'ReserveJet(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Load jet-invariant quantities into a context
+      // ----------------------------------------------------------------------
+      /*! Calculates everything pair-level calculations of `jet` need
+       *  that only depends on the jet (see `JetContext`), so that it's
+       *  done once per jet rather than once per pair. The unit jet
+       *  4-momentum is only calculated if spin-dependent angles use
+       *  it (see `Angles::UsesJetAxis`).
+       */
+      void LoadJetContext(const Type::Jet& jet, JetContext& context) {
+
+        context.jet     = jet;
+        context.vecJet4 = Tools::GetJetVec(jet, false);
+        if (Angles::UsesJetAxis && m_manager.GetDoSpinBins()) {
+          context.unitJet4 = Tools::GetJetVec(jet, true);
+        }
+        context.indices = GetHistIndices(jet);
+        context.spin    = m_spin.HasNullSpin(jet.pattern) ? NULL : &m_spin.Get(jet.pattern);
+        GetJetNorms(context.vecJet4, context.norms);
+        return;
+
+      }  // end 'LoadJetContext(Type::Jet&, JetContext&)'
+
       // ----------------------------------------------------------------------
       //! Do EEC calculation
       // ----------------------------------------------------------------------
       /*! Note that the optional third argument, `evtweight`, is there
        *  to allow for weighting by ckin, spin, etc. By default, it's
        *  set to 1.
+       *
+       *  `icst_a` and `icst_b` are the positions of the constituents
+       *  in the jet. They're only used to key the random spins of
+       *  null-spin patterns (pAu and unknown patterns, see `SetEvent`),
+       *  so that each pair gets the same spin as it does in `CalcEECJet`.
+       *  They should be provided when filling spin-sorted histograms
+       *  for such jets; otherwise every pair of the jet shares 1 spin.
+       *
+       *  N.B. jet quantities are recalculated for every call, so when
+       *  filling several pairs of a jet one at a time, the jet should
+       *  be loaded into a context once (see `LoadJetContext`) and
+       *  passed to the other `CalcEEC`. When looping over all pairs of
+       *  a jet, `CalcEECJet` should be preferred: it also calculates
+       *  constituent quantities only once per jet.
        */ 
       void CalcEEC(
         const Type::Jet& jet,
         const std::pair<Type::Cst, Type::Cst>& csts,
-        const double evt_weight = 1.0
+        const double evt_weight = 1.0,
+        const std::size_t icst_a = 0,
+        const std::size_t icst_b = 0
       ) {
 
-        // calculate jet, cst kinematics --------------------------------------
+        LoadJetContext(jet, m_context);
+        CalcEEC(m_context, csts, evt_weight, icst_a, icst_b);
+        return;
+
+      }  // end 'CalcEEC(Type::Jet&, std::pair<Type::Cst, Type::Cst>&, double, std::size_t x 2)'
 
-        // get jet 4-momenta
-        TLorentzVector vecJet4  = Tools::GetJetLorentz(jet, false);
-        TLorentzVector unitJet4 = Tools::GetJetLorentz(jet, true);
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation for a pair of a pre-loaded jet
+      // ----------------------------------------------------------------------
+      /*! Same as `CalcEEC(Type::Jet&, ...)`, but jet quantities are
+       *  taken from `context`, which should have been loaded by this
+       *  calculator (see `LoadJetContext`).
+       */
+      void CalcEEC(
+        const JetContext& context,
+        const std::pair<Type::Cst, Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        const std::size_t icst_a = 0,
+        const std::size_t icst_b = 0
+      ) {
 
         // get cst 4-momenta
-        std::pair<TLorentzVector, TLorentzVector> vecCst4 = std::make_pair(
-          Tools::GetCstLorentz(csts.first, jet.pt, false),
-          Tools::GetCstLorentz(csts.second, jet.pt, false)
+        std::pair<Type::Vec4, Type::Vec4> vecCst4 = std::make_pair(
+          Tools::GetCstVec(csts.first, context.jet.pt, false),
+          Tools::GetCstVec(csts.second, context.jet.pt, false)
         );
 
-       
-	/*
+        // get EEC weights for each scheme
+        //   - n.b. weights of the 2 cst.s are interleaved
+        m_cst_weights.resize( 2 * GetNSchemes() );
+        GetCstWeights(vecCst4.first, context.norms, &m_cst_weights[0], 2);
+        GetCstWeights(vecCst4.second, context.norms, &m_cst_weights[1], 2);
+
+        // get spin-dependent angles if needed
+        const bool do_angles = m_manager.GetDoEECHists() && m_manager.GetDoSpinBins();
+        if (do_angles) {
+          Angles::Calc(
+            context.jet,
+            context.unitJet4,
+            vecCst4,
+            GetSpin(context, GetPairKey(icst_a, icst_b)),
+            m_pair_angles
+          );
+        }
+
+        // record jet if needed
+        //   - n.b. each pair is recorded as a jet of 2 cst.s
+        const bool do_cache = m_cache && m_manager.GetDoEECHists();
+        if (do_cache) {
+          m_vecs.clear();
+          m_vecs.push_back(vecCst4.first);
+          m_vecs.push_back(vecCst4.second);
+          BeginCachedJet(context, m_vecs, evt_weight);
+        }
 
-	// Collins/Boer-Mulders Analysis
-	  
-        // get average of cst 3-vectors
-        TVector3 vecAvgCst3 = Tools::GetWeightedAvgVector(
-          vecCst4.first.Vect(),
-          vecCst4.second.Vect(),
-          false
-        );
-        TVector3 unitAvgCst3 = Tools::GetWeightedAvgVector(
-          vecCst4.first.Vect(),
-          vecCst4.second.Vect(),
-          true
+        // run calculation and exit
+        DoEECCalc(
+          context,
+          Tools::GetCstDist(csts),
+          &m_cst_weights[0],
+          &m_cst_weights[1],
+          2,
+          evt_weight,
+          do_angles ? &m_pair_angles : NULL
         );
-	*/
+        if (do_cache) m_cache -> EndJet();
+        return;
 
-	// Dihadron FF Analysis
+      }  // end 'CalcEEC(JetContext&, std::pair<Type::Cst, Type::Cst>&, double, std::size_t x 2)'
 
-        // (0) get beam and spin directions
-        //   first  = blue beam/spin
-        //   second = yellow beam/spin
-        std::pair<TVector3, TVector3> vecBeam3 = Tools::GetBeams();
-        std::pair<TVector3, TVector3> vecSpin3 = Tools::GetSpins( jet.pattern );
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation over all pairs of constituents in a jet
+      // ----------------------------------------------------------------------
+      /*! Runs the same calculation as `CalcEEC` over every pair
+       *  (A, B) with B <= A, i.e. the diagonal is included. Jet
+       *  4-momenta, histogram indices, constituent 4-momenta and
+       *  weights are calculated only once per jet, so this is much
+       *  faster than calling `CalcEEC` for each pair.
+       *
+       *  If a selector (e.g. `Tools::IsChargedCst`) is provided,
+       *  only constituents for which it returns true are used.
+       *
+       *  Distances between constituents are calculated a row of
+       *  the pair triangle at a time with a vectorized kernel (see
+       *  `Kernel::GetCstDistRow`), as are spin-dependent angles if
+       *  needed (see `Angles::CalcRow`). For jets with up to
+       *  `Kernel::MaxUnrolled()` constituents, all distances are
+       *  instead calculated at once by a kernel unrolled for that
+       *  multiplicity (see `Kernel::GetCstDistTriangle`).
+       */
+      void CalcEECJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
 
-	// Define the vectors for the angle calculations
+        // run calculation over all rows of the pair triangle
+        CalcEECJetRows(jet, csts, 0, csts.size(), evt_weight, select);
 
-	TVector3 PC = vecCst4.first.Vect() + vecCst4.second.Vect();
-	TVector3 PC_unit = PC.Unit(); 
-	TVector3 RC = 0.5*(vecCst4.first.Vect() - vecCst4.second.Vect());
-	
-	// blue beam is PB, yellow is PA
+        // move on to next jet
+        SetJet(m_jet + 1);
+        return;
 
-	TVector3 PB = vecBeam3.first;
-	TVector3 PB_unit = PB.Unit();
-	TVector3 SB = vecSpin3.first; 
+      }  // end 'CalcEECJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
 
-	TVector3 PA = vecBeam3.second;
-	TVector3 PA_unit = PA.Unit(); 
-	TVector3 SA = vecSpin3.second; 
-	
-	// Blue Polarized
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation over some rows of a jet's pair triangle
+      // ----------------------------------------------------------------------
+      /*! Same as `CalcEECJet`, but only pairs (A, B) with A in [first,
+       *  last) are filled, where A indexes the selected constituents.
+       *  Doesn't move on to the next jet, so that a jet can be split
+       *  into tiles of rows among several shards (see
+       *  `Parallel::JetPool`): a shard should be given the same event
+       *  and jet (see `SetEvent`) as the calculator it was cloned from
+       *  so that null spins are drawn identically.
+       *
+       *  N.B. if a pair cache is set, only the given rows are recorded.
+       */
+      void CalcEECJetRows(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const std::size_t first,
+        const std::size_t last,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
 
-	double cThetaSB = (PB_unit.Cross(PC)*(1.0/(PB_unit.Cross(PC).Mag()))).Dot(PB_unit.Cross(SB)*(1.0/PB_unit.Cross(SB).Mag())); 
-	double sThetaSB = (PC.Cross(SB)).Dot(PB_unit)*(1.0/((PB_unit.Cross(PC).Mag())*(PB_unit.Cross(SB).Mag()))); 
+        // calculate jet quantities -------------------------------------------
 
-	// Yellow Polarized
+        // get jet 4-momenta, hist indices, weight norms, etc.
+        LoadJetContext(jet, m_context);
 
-	double cThetaSA = (PA_unit.Cross(PC)*(1.0/(PA_unit.Cross(PC).Mag()))).Dot(PA_unit.Cross(SA)*(1.0/PA_unit.Cross(SA).Mag())); 
-	double sThetaSA = (PC.Cross(SA)).Dot(PA_unit)*(1.0/((PA_unit.Cross(PC).Mag())*(PA_unit.Cross(SA).Mag()))); 
+        // calculate cst quantities -------------------------------------------
 
-	// Dihadron
+        // get 4-momenta, weights, and (eta, phi) of selected cst.s
+        LoadCsts(m_context, csts, select);
+        m_angles.resize( m_view.Size() );
 
-	double cThetaRC = (PC_unit.Cross(PA)*(1.0/(PC_unit.Cross(PA).Mag()))).Dot(PC_unit.Cross(RC)*(1.0/PC_unit.Cross(RC).Mag())); 
-	double sThetaRC = (PA.Cross(RC)).Dot(PC_unit)*(1.0/((PC_unit.Cross(PA).Mag())*(PC_unit.Cross(RC).Mag()))); 
+        // small jets get all of their distances at once with a kernel
+        // unrolled for their multiplicity (see `GetCstDistTriangle`),
+        // larger ones a row at a time
+        const bool do_triangle = (m_view.Size() > 0) && (m_view.Size() <= Kernel::MaxUnrolled());
+        if (do_triangle) {
+          m_dists.resize( Kernel::GetTriangleOffset(m_view.Size()) );
+          Kernel::GetCstDistTriangle(m_view, &m_dists[0], m_isa);
+        } else {
+          m_dists.resize( m_view.Size() );
+        }
 
-	// Convert to angles in the full range [0,2pi]
+        // check if angles are needed
+        const bool do_angles = m_manager.GetDoEECHists() && m_manager.GetDoSpinBins();
 
-	double ThetaSB = (sThetaSB>0.0) ? acos(cThetaSB) : -acos(cThetaSB); 
-	if (ThetaSB < 0)               ThetaSB += TMath::TwoPi();
-	if (ThetaSB >= TMath::TwoPi()) ThetaSB -= TMath::TwoPi();
+        // record jet if needed
+        const bool do_cache = m_cache && m_manager.GetDoEECHists();
+        if (do_cache) {
+          BeginCachedJet(m_context, m_vecs, evt_weight);
+        }
 
-	double ThetaSA = (sThetaSA>0.0) ? acos(cThetaSA) : -acos(cThetaSA); 
-	if (ThetaSA < 0)               ThetaSA += TMath::TwoPi();
-	if (ThetaSA >= TMath::TwoPi()) ThetaSA -= TMath::TwoPi();
+        // loop over pairs ----------------------------------------------------
+
+        const std::size_t stop = std::min(last, m_view.Size());
+        for (std::size_t ia = first; ia < stop; ++ia) {
+
+          // get distances (and angles) for the whole row at once
+          const double* dists = do_triangle ? &m_dists[Kernel::GetTriangleOffset(ia)] : &m_dists[0];
+          if (!do_triangle) Kernel::GetCstDistRow(m_view, ia, &m_dists[0], m_isa);
+          if (do_angles && m_context.spin) {
+            Angles::CalcRow(
+              jet,
+              m_context.unitJet4,
+              m_vecs,
+              m_view,
+              ia,
+              *m_context.spin,
+              &m_angles[0]
+            );
+          } else if (do_angles) {
+            // n.b. null spins are drawn for each pair
+            for (std::size_t ib = 0; ib <= ia; ++ib) {
+              Angles::Calc(
+                jet,
+                m_context.unitJet4,
+                std::make_pair(m_vecs[ia], m_vecs[ib]),
+                GetSpin(m_context, GetPairKey(ia, ib)),
+                m_angles[ib]
+              );
+            }
+          }
+          for (std::size_t ib = 0; ib <= ia; ++ib) {
+            DoEECCalc(
+              m_context,
+              dists[ib],
+              &m_weights[ia],
+              &m_weights[ib],
+              m_view.Size(),
+              evt_weight,
+              do_angles ? &m_angles[ib] : NULL,
+              ia,
+              ib
+            );
+          }
+        }
+        if (do_cache) m_cache -> EndJet();
+        return;
 
-	double ThetaRC = (sThetaRC>0.0) ? acos(cThetaRC) : -acos(cThetaRC);
-	if (ThetaRC < 0)               ThetaRC += TMath::TwoPi();
-	if (ThetaRC >= TMath::TwoPi()) ThetaRC -= TMath::TwoPi();
+      }  // end 'CalcEECJetRows(Type::Jet&, std::vector<Type::Cst>&, std::size_t, std::size_t, double, bool (*)(Type::Cst&))'
 
-	// The angle differences in the full range [0,2pi]
+      // ----------------------------------------------------------------------
+      //! Queue a jet for a batched EEC calculation
+      // ----------------------------------------------------------------------
+      /*! Same result as `CalcEECJet`, but aimed at low-multiplicity
+       *  (e.g. pp) jets, which have too few pairs for the row kernels
+       *  to fill their lanes. Jet and constituent quantities are
+       *  calculated right away, and the jet is
+       *  queued with others of the same multiplicity (see `JetBatch`);
+       *  once `nlanes` jets are queued (see `SetBatchSize`, batching
+       *  is off by default), the batch is processed a pair slot at a
+       *  time across all of its jets.
+       *
+       *  Jets with more than `max_cst` constituents, jets with a null
+       *  spin when spin-sorted histograms are filled (their spins are
+       *  drawn per pair), or any jet if a pair cache is set, are
+       *  processed right away by `CalcEECJet`.
+       *  Queued jets are processed by `FlushEECBatches`, which `End`
+       *  calls; it should also be called before retrieving histograms
+       *  and on shards before they're merged.
+       *
+       *  N.B. histograms are filled in a different order than with
+       *  `CalcEECJet`, so sums can differ in the last bits.
+       */
+      void BatchEECJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
 
-	double ThetaSB_RC = ThetaSB - ThetaRC; 
-	if (ThetaSB_RC < 0)               ThetaSB_RC += TMath::TwoPi();
-	if (ThetaSB_RC >= TMath::TwoPi()) ThetaSB_RC -= TMath::TwoPi();
+        // if batching isn't possible, run calculation now
+        const bool is_null = m_manager.GetDoSpinBins() && m_spin.HasNullSpin(jet.pattern);
+        if (m_cache || is_null || (m_batch_lanes <= 1) || (csts.size() > m_batch_max) || !m_manager.GetDoEECHists()) {
+          CalcEECJet(jet, csts, evt_weight, select);
+          return;
+        }
 
-	double ThetaSA_RC = ThetaSA - ThetaRC; 
-	if (ThetaSA_RC < 0)               ThetaSA_RC += TMath::TwoPi();
-	if (ThetaSA_RC >= TMath::TwoPi()) ThetaSA_RC -= TMath::TwoPi();
-	
-	/*
+        // calculate jet & cst quantities
+        LoadJetContext(jet, m_context);
+        LoadCsts(m_context, csts, select);
+
+        // add jet to batch of its multiplicity
+        const std::size_t ncst = m_view.Size();
+        if (ncst > 0) {
+          if (m_batches.size() <= ncst) m_batches.resize(ncst + 1);
+          JetBatch& batch = m_batches[ncst];
+          if (batch.nlane != m_batch_lanes) {
+            batch.Reset(ncst, m_batch_lanes, GetNSchemes());
+          }
+          batch.Add(
+            m_context,
+            evt_weight,
+            m_view,
+            m_vecs,
+            &m_weights[0]
+          );
+          if (batch.Full()) DoEECBatch(batch);
+        }
 
-        // collins & boer-mulders angle calculations --------------------------
+        // move on to next jet
+        SetJet(m_jet + 1);
+        return;
 
-        // (0) get beam and spin directions
-        //   first  = blue beam/spin
-        //   second = yellow beam/spin
-        std::pair<TVector3, TVector3> vecBeam3 = Tools::GetBeams();
-        std::pair<TVector3, TVector3> vecSpin3 = Tools::GetSpins( jet.pattern );
+      }  // end 'BatchEECJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
 
-        // (1) get vectors normal to the jet-beam plane
-        std::pair<TVector3, TVector3> normJetBeam3 = std::make_pair(
-          ( vecBeam3.first.Cross(unitJet4.Vect()) ).Unit(),
-          ( vecBeam3.second.Cross(unitJet4.Vect()) ).Unit()
-        );
+      // ----------------------------------------------------------------------
+      //! Process all queued jet batches
+      // ----------------------------------------------------------------------
+      void FlushEECBatches() {
 
-        // (2) get phiSpin: angles between the jet-beam plane and spin
-        //   - n.b. for spin pattern >= 4, the yellow spin is randomized
-	//   - angle between jet plane and spin 
+        FlushEECBatches(0, m_batches.size());
+        return;
 
-        // get vectors normal to the spin-beam plane
-        std::pair<TVector3, TVector3> normJetSpin = std::make_pair(
-          ( vecBeam3.first.Cross(vecSpin3.first) ).Unit(),
-          ( vecBeam3.second.Cross(vecSpin3.second) ).Unit()
-        );
+      }  // end 'FlushEECBatches()'
 
-        double phiSpinBlue = atan2( normJetBeam3.first.Cross(normJetSpin.first).Mag(), normJetBeam3.first.Dot(normJetSpin.first) );
-        double phiSpinYell = atan2( normJetBeam3.second.Cross(normJetSpin.second).Mag(), normJetBeam3.second.Dot(normJetSpin.second) );
-
-	// define the zero of phiSpin as the jet-beam plane and the sense of rotation 
-	// the result will be in [0,2pi]
-
-	if(normJetBeam3.first.Dot(vecSpin3.first)<0.0) phiSpinBlue = TMath::TwoPi() - phiSpinBlue; 
-	if(normJetBeam3.second.Dot(vecSpin3.second)<0.0) phiSpinYell = TMath::TwoPi() - phiSpinYell; 
-
-        // (3) get vector normal to hadron average-jet plane
-        TVector3 normHadJet3 = ( unitJet4.Vect().Cross(unitAvgCst3) ).Unit();
-
-        // (4) get phiHadron: angle between the jet-beam plane and the
-        //   - angle between jet-hadron plane
-        //   - constrain to range [0,2pi)
-        double phiHadBlue = atan2( normJetBeam3.first.Cross(normHadJet3).Mag(), normJetBeam3.first.Dot(normHadJet3) );
-        double phiHadYell = atan2( normJetBeam3.second.Cross(normHadJet3).Mag(), normJetBeam3.second.Dot(normHadJet3) );
-	
-	// define the zero of phiHad as the jet-beam plane and the sense of rotation
-	// the result will be in [0,2pi]
-
-	if(normJetBeam3.first.Dot(unitAvgCst3)<0.0) phiHadBlue = TMath::TwoPi() - phiHadBlue; 
-	if(normJetBeam3.second.Dot(unitAvgCst3)<0.0) phiHadYell = TMath::TwoPi() - phiHadYell; 
-
-        // (5) double phiHadron for boer-mulders,
-        //   - constrain to [0, 2pi)
-        double phiHadBlue2 = 2.0 * phiHadBlue;
-        double phiHadYell2 = 2.0 * phiHadYell;
-	if (phiHadBlue2 < 0)               phiHadBlue2 += TMath::TwoPi();
-	if (phiHadBlue2 >= TMath::TwoPi()) phiHadBlue2 -= TMath::TwoPi();
-        if (phiHadYell2 < 0)               phiHadYell2 += TMath::TwoPi();
-	if (phiHadYell2 >= TMath::TwoPi()) phiHadYell2 -= TMath::TwoPi();
-
-        // (6) now calculate phiColl: phiSpin - phiHadron,
-        //   - constrain to [0, 2pi)
-        double phiCollBlue = phiSpinBlue - phiHadBlue;
-        double phiCollYell = phiSpinYell - phiHadYell;
-	if (phiCollBlue < 0)               phiCollBlue += TMath::TwoPi();
-	if (phiCollBlue >= TMath::TwoPi()) phiCollBlue -= TMath::TwoPi();
-	if (phiCollYell < 0)               phiCollYell += TMath::TwoPi();
-	if (phiCollYell >= TMath::TwoPi()) phiCollYell -= TMath::TwoPi();
-
-        // (7) now calculate phiBoer: phiSpin - (2 * phiHadron),
-        double phiBoerBlue = phiSpinBlue - phiHadBlue2;
-        double phiBoerYell = phiSpinYell - phiHadYell2;
-
-        // (8) constrain phiBoerBlue to [0, 2pi)
-	if (phiBoerBlue < 0)               phiBoerBlue += TMath::TwoPi();
-	if (phiBoerBlue >= TMath::TwoPi()) phiBoerBlue -= TMath::TwoPi();
-
-        // (9) constrain to phiBoerYell to [0, 2pi)
-	if (phiBoerYell < 0)               phiBoerYell += TMath::TwoPi();
-	if (phiBoerYell >= TMath::TwoPi()) phiBoerYell -= TMath::TwoPi();
- 
-	*/
+      // ----------------------------------------------------------------------
+      //! Process queued jet batches in a range of multiplicities
+      // ----------------------------------------------------------------------
+      /*! Only batches of jets with [first, last) selected constituents
+       *  are processed.
+       */
+      void FlushEECBatches(const std::size_t first, const std::size_t last) {
 
-        // calculate eec quantities -------------------------------------------
+        const std::size_t stop = std::min(last, m_batches.size());
+        for (std::size_t ibatch = first; ibatch < stop; ++ibatch) {
+          if (!m_batches[ibatch].Empty()) DoEECBatch( m_batches[ibatch] );
+        }
+        return;
 
-        // get EEC weights
-        std::pair<double, double> cst_weights = std::make_pair(
-          GetCstWeight(vecCst4.first, vecJet4),
-          GetCstWeight(vecCst4.second, vecJet4)
-        );
+      }  // end 'FlushEECBatches(std::size_t, std::size_t)'
 
-        // and then calculate RL (dist b/n cst.s for EEC) and overall EEC weight
-        const double dist    = Tools::GetCstDist(csts);
-        const double weight  = cst_weights.first * cst_weights.second * evt_weight;
+      // ----------------------------------------------------------------------
+      //! Refill EEC histograms from a pair cache
+      // ----------------------------------------------------------------------
+      /*! Replays every pair recorded in `cache`, only recalculating the
+       *  weights: constituent weights are recalculated with this
+       *  calculator's weight scheme(s), and the geometry (R_{L} and
+       *  angle bins, histogram indices) is taken from the cache.
+       *
+       *  By default the recorded event weight is used; if `reweight` is
+       *  provided, it's called for each jet to get a new one (e.g. to
+       *  apply ckin cross-sections). If `cst_factor` is provided, each
+       *  constituent weight is multiplied by it (e.g. to apply an
+       *  efficiency correction).
+       *
+       *  Requires the flat backend, and the same binning as the
+       *  calculator that recorded the cache.
+       */
+      void ReplayEEC(
+        PairCache& cache,
+        double (*reweight)(const PairCache::JetRecord&) = NULL,
+        double (*cst_factor)(const Type::Vec4&) = NULL
+      ) {
 
-        // fill histograms ---------------------------------------------------=
+        // throw error if not using flat backend
+        if (!m_manager.UsesAccumulators()) {
+          assert(m_manager.UsesAccumulators());
+        }
+        if (!m_manager.GetDoEECHists()) return;
+
+        PairCache::Block block;
+        cache.Rewind();
+        while (cache.NextJet(block)) {
+
+          // get event and cst weights for each scheme
+          const double      evt_weight = reweight ? reweight(block.jet) : block.jet.evt_weight;
+          const std::size_t ncst       = block.jet.ncst;
+          GetJetNorms(block.jet.jet4, m_context.norms);
+          m_weights.resize( GetNSchemes() * ncst );
+          for (std::size_t icst = 0; icst < ncst; ++icst) {
+            GetCstWeights(block.csts[icst], m_context.norms, &m_weights[icst], ncst);
+            if (cst_factor) {
+              const double factor = cst_factor(block.csts[icst]);
+              for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+                m_weights[(isch * ncst) + icst] *= factor;
+              }
+            }
+          }
 
-        // fill histograms if needed
-        if (m_manager.GetDoEECHists()) {
+          // then refill each pair
+          for (std::size_t ipair = 0; ipair < block.jet.npair; ++ipair) {
+            const PairCache::PairRecord& pair = block.pairs[ipair];
+            for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+              const double* weights = &m_weights[isch * ncst];
+              GetSchemeManager(isch).FillEECCells(
+                block.indices,
+                block.jet.nindex,
+                pair.cells,
+                weights[pair.ia] * weights[pair.ib] * evt_weight
+              );
+            }
+          }
+        }  // end jet loop
+        return;
 
-          // grab hist indices
-          std::vector<Type::HistIndex> indices = GetHistIndices(jet);
+      }  // end 'ReplayEEC(PairCache&, double (*)(PairCache::JetRecord&), double (*)(Type::Vec4&))'
 
-	  // Collins/Boer-Mulders
 
-	  /*
-          // collect quantities to be histogrammed
-          Type::HistContent content(weight, dist);
-          if (m_manager.GetDoSpinBins()) {
-            content.phiCollB = phiCollBlue;
-            content.phiCollY = phiCollYell;
-            content.phiBoerB = phiBoerBlue;
-            content.phiBoerY = phiBoerYell;
-            content.spinB    = vecSpin3.first.Y();
-            content.spinY    = vecSpin3.second.Y();
-            content.pattern  = jet.pattern;
+      // ----------------------------------------------------------------------
+      //! Do E3C calculation over all triplets of constituents in a jet
+      // ----------------------------------------------------------------------
+      /*! Fills the E3C histograms for every triplet (A, B, C) of
+       *  distinct constituents with C < B < A, weighted by the product
+       *  of the 3 constituent weights (and `evt_weight`). As with
+       *  `CalcEECJet`, a selector can be provided to only use some
+       *  constituents.
+       *
+       *  Distances between all pairs are calculated once per jet and
+       *  stored in a packed triangular matrix. Then for each pair
+       *  (A, B), the shapes of all triangles (A, B, C) are calculated
+       *  from rows A and B of the matrix in one pass (see
+       *  `Kernel::GetE3CShapesRow`), so nothing is recomputed per
+       *  triplet.
+       */
+      void CalcE3CJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
+
+        // nothing to do if not filling histograms
+        if (!m_manager.GetDoE3CHists()) return;
+
+        // calculate jet quantities -------------------------------------------
+
+        // get jet 4-momentum, hist indices, weight norms, etc.
+        LoadJetContext(jet, m_context);
+        const Type::IndexList& indices = m_context.indices;
+
+        // calculate cst quantities -------------------------------------------
+
+        // get 4-momenta, weights, and (eta, phi) of selected cst.s
+        LoadCsts(m_context, csts, select);
+
+        // get distances between all pairs
+        const std::size_t ncst = m_view.Size();
+        m_dists.resize( Kernel::GetTriangleOffset(ncst) );
+        m_shapes.resize( ncst );
+        if (ncst > 0) Kernel::GetCstDistTriangle(m_view, &m_dists[0], m_isa);
+
+        // loop over triplets -------------------------------------------------
+
+        for (std::size_t ia = 2; ia < ncst; ++ia) {
+          const double* dist_a = &m_dists[Kernel::GetTriangleOffset(ia)];
+          for (std::size_t ib = 1; ib < ia; ++ib) {
+
+            // get shapes of all triangles (A, B, C < B) at once
+            const double* dist_b = &m_dists[Kernel::GetTriangleOffset(ib)];
+            Kernel::GetE3CShapesRow(dist_a[ib], dist_a, dist_b, ib, &m_shapes[0]);
+
+            // then weight and fill for each scheme
+            for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+              const double*     weights   = &m_weights[isch * ncst];
+              const double      weight_ab = weights[ia] * weights[ib] * evt_weight;
+              HistManager&      manager   = GetSchemeManager(isch);
+              for (std::size_t ic = 0; ic < ib; ++ic) {
+                m_shapes[ic].weight = weight_ab * weights[ic];
+                manager.FillE3CHists(indices, m_shapes[ic]);
+              }
+            }
           }
-	  */
+        }
+        return;
 
-	  // Dihadron FF
+      }  // end 'CalcE3CJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
 
-          // collect quantities to be histogrammed
-          Type::HistContent content(weight, dist);
-          if (m_manager.GetDoSpinBins()) {
-            content.phiCollB = ThetaSB_RC;
-            content.phiCollY = ThetaSA_RC;
-            content.phiBoerB = 0.0;
-            content.phiBoerY = 0.0;
-            content.spinB    = vecSpin3.first.Y();
-            content.spinY    = vecSpin3.second.Y();
-            content.pattern  = jet.pattern;
+
+      // ----------------------------------------------------------------------
+      //! Do projected N-point calculation over a jet
+      // ----------------------------------------------------------------------
+      /*! Fills the "ENCStat" histograms with the projected N-point
+       *  correlator (N set by `SetENCOrder`), i.e. every set of N
+       *  distinct constituents weighted by the product of their weights
+       *  (and `evt_weight`) at its largest pairwise distance R_L.
+       *
+       *  Rather than enumerating sets, pairs are sorted by R_L. A set's
+       *  R_L is that of its last pair (A, B) in this order, and its
+       *  other members must be "inside" (A, B): closer to both A and B
+       *  than they are to each other (see `Kernel::GetInsideCsts`).
+       *  Each pair then gets w_A * w_B times the summed weights of the
+       *  sets of N - 2 constituents inside it:
+       *    - For N <= 3, or if `fast` was set, this is the elementary
+       *      symmetric polynomial e_{N-2} of the inside weights (see
+       *      `Kernel::GetSymPoly`). The cost is O(n^2 log n) for the
+       *      sort plus O(n) per pair, so O(n^3) per jet regardless of
+       *      N.
+       *    - Otherwise, pairs among the inside constituents must also
+       *      be closer than (A, B), so only such sets are summed (see
+       *      `Kernel::GetCliqueSum`). This scales with the number of
+       *      sets instead, i.e. up to O(n^N) per jet.
+       *
+       *  The exact sums are only practical for low multiplicities: for
+       *  N = 5 they took ~10 ms per jet at n = 50, ~0.35 s at n = 100,
+       *  and ~8 s at n = 200 (N = 4: ~2 ms, ~25 ms and ~0.3 s). Higher
+       *  multiplicities should use `fast` or a selector (e.g. charged
+       *  constituents only).
+       *
+       *  Histograms are filled once per pair with the summed weight of
+       *  all of its sets, so their contents match a fill per set, but
+       *  their errors (sum of w^2) and entries don't.
+       *
+       *  N.B. for N >= 4, the `fast` option is only an upper bound: it
+       *  counts sets whose inside members are wider apart than (A, B)
+       *  at the R_L of (A, B), which shifts weight to smaller R_L.
+       */
+      void CalcENCJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
+
+        // nothing to do if not filling histograms
+        if (!m_manager.GetDoENCHists()) return;
+
+        // calculate jet quantities -------------------------------------------
+
+        // get jet 4-momentum, hist indices, weight norms, etc.
+        LoadJetContext(jet, m_context);
+        const Type::IndexList& indices = m_context.indices;
+
+        // calculate cst quantities -------------------------------------------
+
+        // get 4-momenta, weights, and (eta, phi) of selected cst.s
+        LoadCsts(m_context, csts, select);
+
+        // get distances between all pairs
+        const std::size_t ncst = m_view.Size();
+        m_dists.resize( Kernel::GetTriangleOffset(ncst) );
+        if (ncst > 0) Kernel::GetCstDistTriangle(m_view, &m_dists[0], m_isa);
+
+        // sort distinct pairs by R_L
+        m_pairs.clear();
+        for (std::size_t ia = 1; ia < ncst; ++ia) {
+          for (std::size_t ib = 0; ib < ia; ++ib) {
+            const std::size_t ipair = Kernel::GetTriangleOffset(ia) + ib;
+            m_pairs.push_back( std::make_pair(m_dists[ipair], (ia * ncst) + ib) );
           }
+        }
+        std::sort(m_pairs.begin(), m_pairs.end());
+
+        // then rank them
+        //   - n.b. the diagonal ranks after every pair
+        m_ranks.assign(ncst * ncst, m_pairs.size());
+        for (std::size_t rank = 0; rank < m_pairs.size(); ++rank) {
+          const std::size_t ia = m_pairs[rank].second / ncst;
+          const std::size_t ib = m_pairs[rank].second % ncst;
+          m_ranks[(ia * ncst) + ib] = rank;
+          m_ranks[(ib * ncst) + ia] = rank;
+        }
 
-          // fill spin-integrated histograms
-          for (std::size_t idx = 0; idx < Const::NBinsPerSpin(); ++idx) {
-            m_manager.FillEECHists(indices[idx], content);
+        // loop over pairs ----------------------------------------------------
+
+        const std::size_t order = m_manager.GetENCOrder() - 2;
+        const bool        use_esp = (order <= 1) || m_enc_fast;
+        for (std::size_t rank = 0; rank < m_pairs.size(); ++rank) {
+
+          // get constituents inside pair
+          const std::size_t ia = m_pairs[rank].second / ncst;
+          const std::size_t ib = m_pairs[rank].second % ncst;
+          Kernel::GetInsideCsts(&m_ranks[ia * ncst], &m_ranks[ib * ncst], rank, ncst, m_inside);
+          if (m_inside.size() < order) continue;
+
+          // for each scheme, sum weights of sets of them
+          for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+            const double* weights = &m_weights[isch * ncst];
+            const double  sets    = use_esp
+              ? Kernel::GetSymPoly(weights, m_inside, order, m_esp)
+              : Kernel::GetCliqueSum(&m_ranks[0], ncst, rank, weights, m_inside, order, m_cliques);
+            if (sets == 0.) continue;
+
+            // then fill histograms
+            Type::HistContent content(weights[ia] * weights[ib] * sets * evt_weight, m_pairs[rank].first);
+            GetSchemeManager(isch).FillENCHists(indices, content);
           }
+        }
+        return;
 
-          // if needed, fill spin sorted histograms
-          if (m_manager.GetDoSpinBins() && (indices.size() > Const::BlueSpinStart())) {
+      }  // end 'CalcENCJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
 
-            // fill blue spins
-            for (
-              std::size_t idx = Const::BlueSpinStart();
-              idx < Const::YellSpinStart();
-              ++idx
-            ) {
-              m_manager.FillEECHists(indices[idx], content);
-            }
 
-            // fill yellow and both spins
-            if (indices.size() > Const::YellSpinStart()) {
-              for (
-                std::size_t idx = Const::YellSpinStart();
-                idx < indices.size();
-                ++idx
-              ) {
-                m_manager.FillEECHists(indices[idx], content);
-              }
-            }
-          }  // end spin hist filling
-        }  // end hist filing
+      // ----------------------------------------------------------------------
+      //! Find leading constituent (lambda) of a jet
+      // ----------------------------------------------------------------------
+      /*! Returns the index of the selected constituent with the highest
+       *  score, which is its momentum fraction z by default (see
+       *  `SetLambdaScore`). Ties go to the first one. If no constituent
+       *  is selected, `csts.size()` is returned.
+       */
+      std::size_t FindLambda(
+        const std::vector<Type::Cst>& csts,
+        bool (*select)(const Type::Cst&) = NULL
+      ) const {
+
+        std::size_t lambda = csts.size();
+        double      best   = 0.;
+        for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+
+          // skip cst.s which aren't selected
+          if (select && !select(csts[icst])) continue;
+
+          const double score = m_lambda_score(csts[icst]);
+          if ((lambda == csts.size()) || (score > best)) {
+            lambda = icst;
+            best   = score;
+          }
+        }
+        return lambda;
+
+      }  // end 'FindLambda(std::vector<Type::Cst>&, bool (*)(Type::Cst&))'
+
+      // ----------------------------------------------------------------------
+      //! Do LEC calculation over a jet
+      // ----------------------------------------------------------------------
+      /*! Correlates every other selected constituent with the leading
+       *  one (see `FindLambda`): each is filled at its distance to
+       *  lambda, weighted by its own weight (and `evt_weight`). This
+       *  takes one pass to find lambda and one to fill, so it's O(n)
+       *  per jet.
+       */
+      void CalcLECJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
+
+        // nothing to do if not filling histograms
+        if (!m_manager.GetDoLECHists()) return;
+
+        // find leading cst
+        const std::size_t lambda = FindLambda(csts, select);
+        if (lambda == csts.size()) return;
+
+        // get jet 4-momentum, hist indices, weight norms, etc.
+        LoadJetContext(jet, m_context);
+
+        // correlate other cst.s with lambda
+        m_cst_weights.resize( GetNSchemes() );
+        for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+
+          // skip lambda and cst.s which aren't selected
+          if (icst == lambda) continue;
+          if (select && !select(csts[icst])) continue;
+
+          const Type::Vec4 vecCst4 = Tools::GetCstVec(csts[icst], jet.pt, false);
+          GetCstWeights(vecCst4, m_context.norms, &m_cst_weights[0], 1);
+          DoLECCalc(
+            m_context,
+            Tools::GetCstDist( std::make_pair(csts[lambda], csts[icst]) ),
+            &m_cst_weights[0],
+            evt_weight
+          );
+        }
         return;
 
-      }  // end 'CalcEEC(Type::Jet&, std::pair<Type::Cst, Type::Cst>&, double)'
+      }  // end 'CalcLECJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
+
+
+      // ----------------------------------------------------------------------
+      //! Make an empty copy of this calculator
+      // ----------------------------------------------------------------------
+      /*! The clone has the same options, weight schemes and histogram
+       *  layout, but its own (empty) histograms, so that each thread can
+       *  fill its own shard. Shards are then combined with `Merge`. The
+       *  caller owns the returned calculator.
+       *
+       *  With the atomic backend, the clone shares histogram contents
+       *  with this calculator rather than having its own.
+       *
+       *  N.B. the pair cache (if any) isn't shared with the clone.
+       */
+      BasicCalculator* Clone() const {
+
+        BasicCalculator* clone = new BasicCalculator(*this);
+        clone -> m_manager = m_manager.Clone();
+        for (std::size_t isch = 0; isch < m_scheme_managers.size(); ++isch) {
+          clone -> m_scheme_managers[isch] = m_scheme_managers[isch].Clone();
+        }
+        clone -> m_cache = NULL;
+        clone -> m_batches.clear();
+        return clone;
+
+      }  // end 'Clone()'
+
+      // ----------------------------------------------------------------------
+      //! Add histograms of another calculator
+      // ----------------------------------------------------------------------
+      /*! For reproducible output, shards should always be merged in the
+       *  same order (e.g. by thread number). Queued jet batches of
+       *  `other` aren't merged, so it should be flushed first (see
+       *  `FlushEECBatches`).
+       */
+      void Merge(const BasicCalculator& other) {
+
+        // throw error if schemes don't match
+        if (m_scheme_managers.size() != other.m_scheme_managers.size()) {
+          assert(m_scheme_managers.size() == other.m_scheme_managers.size());
+        }
+
+        m_manager.Merge(other.m_manager);
+        for (std::size_t isch = 0; isch < m_scheme_managers.size(); ++isch) {
+          m_scheme_managers[isch].Merge(other.m_scheme_managers[isch]);
+        }
+        return;
+
+      }  // end 'Merge(BasicCalculator&)'
 
       // ----------------------------------------------------------------------
       //! End calculations
       // ----------------------------------------------------------------------
       void End(TFile* file) {
 
-        // save histograms to file
-        m_manager.SaveHists(file);
+        // process any jets still waiting in a batch
+        FlushEECBatches();
+
+        // save histograms of each scheme to file
+        for (std::size_t isch = 0; isch < GetNSchemes(); ++isch) {
+          GetSchemeManager(isch).SaveHists(file);
+        }
         return;
 
       }  // end 'End(TFile*)'
@@ -628,29 +1654,51 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       //! default ctor
       // ----------------------------------------------------------------------
-      Calculator()  {
-
-        m_weight_power = 1.0;
-        m_weight_type  = Type::Pt;
+      BasicCalculator()  {
+
+        m_weight_power = Weights::GetPower(1.0);
+        m_weight_type  = Weights::GetType(Type::Pt);
+        m_lambda_score = Tools::GetCstZ;
+        m_isa          = Kernel::GetBestISA();
+        m_enc_fast     = false;
+        m_batch_lanes  = 1;
+        m_batch_max    = 8;
+        m_cache        = NULL;
+        m_event        = 0;
+        m_jet          = 0;
 
       }  // end default ctor
 
       // ----------------------------------------------------------------------
       //! default dtor
       // ----------------------------------------------------------------------
-      ~Calculator() {};
+      ~BasicCalculator() {};
 
       // ----------------------------------------------------------------------
       //! ctor accepting arguments
       // ----------------------------------------------------------------------
-      Calculator(const Type::Weight weight, const double power = 1.0) {
-
-        m_weight_power = power;
-        m_weight_type  = weight;
+      BasicCalculator(const Type::Weight weight, const double power = 1.0) {
+
+        m_weight_power = Weights::GetPower(power);
+        m_weight_type  = Weights::GetType(weight);
+        m_lambda_score = Tools::GetCstZ;
+        m_isa          = Kernel::GetBestISA();
+        m_enc_fast     = false;
+        m_batch_lanes  = 1;
+        m_batch_max    = 8;
+        m_cache        = NULL;
+        m_event        = 0;
+        m_jet          = 0;
 
       }  // end ctor(Type::Weight, double)
 
-  };  // end PHEnergyCorrelator::Calculator
+  };  // end PHEnergyCorrelator::BasicCalculator
+
+  // --------------------------------------------------------------------------
+  //! Calculators for each analysis
+  // --------------------------------------------------------------------------
+  typedef BasicCalculator<DiFFAngles>    Calculator;
+  typedef BasicCalculator<CollinsAngles> CollinsCalculator;
 
 }  // end PHEnergyCorrelator namespace
 
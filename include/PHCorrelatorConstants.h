@@ -13,17 +13,13 @@
 
 // c++ utilities
 #include <limits>
+#include <stdint.h>
 #include <string>
 // root libraries
 #include <TVector3.h>
-#include <TRandom3.h>
 
 namespace PHEnergyCorrelator {
 
-  // Random generator for null spin vector
-
-  TRandom3 *rand = new TRandom3(); 
-
   // ==========================================================================
   //! PHEnergyCorrelator Constants
   // ==========================================================================
@@ -173,11 +169,22 @@ namespace PHEnergyCorrelator {
     // problems with the vector calculations.  Since there is in principle no 
     // spin dependence this should be a valid thing to do. 
     // ------------------------------------------------------------------------
-    inline TVector3 SpinNull() {
-      const TVector3 null(rand->Uniform(), rand->Uniform(), 0.0);
+    /*! Takes 2 uniform random numbers in [0, 1) for the x and y
+     *  components (see `Tools::GetCounterUniform`).
+     */
+    inline TVector3 SpinNull(const double ux, const double uy) {
+      const TVector3 null(ux, uy, 0.0);
       return null.Unit();
     }
 
+    // ------------------------------------------------------------------------
+    //! Default seed for null spins
+    // ------------------------------------------------------------------------
+    inline uint64_t SpinSeed() {
+      const uint64_t seed = 4357;
+      return seed;
+    }
+
   }   // end Const namespace
 }  // end PHEnergyCorrelator namespace
 
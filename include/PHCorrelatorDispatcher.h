@@ -0,0 +1,530 @@
+/// ============================================================================
+/*! \file    PHCorrelatorDispatcher.h
+ *  \authors Derek Anderson
+ *  \date    10.16.2026
+ *
+ *  Driver which times the available pair-loop paths
+ *  of per-jet EEC calculations and picks the fastest
+ *  one for each range of jet multiplicities.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORDISPATCHER_H
+#define PHCORRELATORDISPATCHER_H
+
+// c++ utilities
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// n.b. wall-clock timing needs c++11
+#if __cplusplus >= 201103L
+#include <chrono>
+#endif
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorParallel.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Adaptive pair-loop dispatcher
+  // ==========================================================================
+  /*! Routes each jet to one of the pair-loop paths of a calculator
+   *  (see `Type::Path`):
+   *
+   *    - `Scalar`:   `CalcEECJet` with scalar kernels,
+   *    - `SIMDRow`:  `CalcEECJet` with the best vectorized kernels,
+   *    - `Batched`:  `BatchEECJet` (only if batching is turned on,
+   *                  and for multiplicities which can be batched,
+   *                  see `SetBatchSize`),
+   *    - `Threaded`: a `Parallel::JetPool` (only if more than 1
+   *                  thread is requested, needs c++11).
+   *
+   *  Jets are grouped into buckets of (selected) multiplicity: [0, 4),
+   *  [4, 8), [8, 16), ..., [256, inf). The first `nwarm` jets in a
+   *  bucket are spread among the available paths and timed; once
+   *  every path has seen `nwarm` jets, the one with the lowest time
+   *  per pair is locked in for that bucket. Warm-up jets are filled
+   *  like any other jets, so nothing is processed twice.
+   *
+   *  A count of jets per multiplicity is kept throughout, and the
+   *  chosen policy is printed to stdout as each bucket is locked in
+   *  and by `Finish` (see `SetVerbose`, `PrintPolicy`).
+   *
+   *  Paths differ in the order histograms are filled in, so sums can
+   *  differ in the last bits depending on which path is picked. For
+   *  reproducibility studies, a path can be pinned with `SetPath`.
+   *
+   *    PHEC::Dispatcher<PHEC::Calculator> dispatch(calc, 8);
+   *    for (...) {
+   *      calc.SetEvent(entry);
+   *      dispatch.CalcEECJet(jet, csts);
+   *    }
+   *    dispatch.Finish();
+   *    calc.End(file);
+   */
+  template <typename Calc> class Dispatcher {
+
+    public:
+
+      // no. of paths (excl. Auto) and multiplicity buckets
+      enum {NPaths = 4, NBuckets = 8};
+
+    private:
+
+      // ----------------------------------------------------------------------
+      //! Timings of a multiplicity bucket
+      // ----------------------------------------------------------------------
+      struct Bucket {
+
+        // data members
+        uint64_t    njet;
+        std::size_t ntrial[NPaths];
+        double      time[NPaths];
+        double      pairs[NPaths];
+        Type::Path  path;
+
+        //! default ctor
+        Bucket() : njet(0), path(Type::Auto) {
+          for (std::size_t ipath = 0; ipath < NPaths; ++ipath) {
+            ntrial[ipath] = 0;
+            time[ipath]   = 0.;
+            pairs[ipath]  = 0.;
+          }
+        }
+
+      };  // end Bucket
+
+      // data members (options)
+      Calc&       m_calc;
+      Type::Path  m_pin;
+      std::size_t m_nwarm;
+      bool        m_verbose;
+      bool        m_finished;
+
+      // data members (state)
+      std::vector<uint64_t> m_mult;
+      std::vector<Bucket>   m_buckets;
+#if __cplusplus >= 201103L
+      Parallel::JetPool<Calc>* m_pool;
+#endif
+
+      // ----------------------------------------------------------------------
+      //! Get current time (in s)
+      // ----------------------------------------------------------------------
+      static double GetTime() {
+
+#if __cplusplus >= 201103L
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+        return ((double) std::clock()) / CLOCKS_PER_SEC;
+#endif
+
+      }  // end 'GetTime()'
+
+      // ----------------------------------------------------------------------
+      //! Check if a thread pool is available
+      // ----------------------------------------------------------------------
+      bool HasPool() const {
+
+#if __cplusplus >= 201103L
+        return m_pool != NULL;
+#else
+        return false;
+#endif
+
+      }  // end 'HasPool()'
+
+      // ----------------------------------------------------------------------
+      //! Check if a path should be timed for a bucket
+      // ----------------------------------------------------------------------
+      /*! The vectorized path is only a candidate if the cpu supports
+       *  vector kernels, and the batched path only if every
+       *  multiplicity of the bucket can be batched.
+       */
+      bool IsCandidate(const Type::Path path, const std::size_t ibkt) const {
+
+        switch (path) {
+          case Type::Scalar:
+            return true;
+          case Type::SIMDRow:
+            return Kernel::GetBestISA() != Kernel::Scalar;
+          case Type::Batched:
+            return (ibkt + 1 < NBuckets)
+                && (m_calc.GetBatchLanes() > 1)
+                && (GetBucketLow(ibkt + 1) <= m_calc.GetBatchMax() + 1);
+          case Type::Threaded:
+            return HasPool();
+          default:
+            return false;
+        }
+
+      }  // end 'IsCandidate(Type::Path, std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Run a jet through a path
+      // ----------------------------------------------------------------------
+      void RunPath(
+        const Type::Path path,
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight,
+        bool (*select)(const Type::Cst&)
+      ) {
+
+        switch (path) {
+          case Type::Batched:
+            m_calc.BatchEECJet(jet, csts, evt_weight, select);
+            break;
+          case Type::Threaded:
+#if __cplusplus >= 201103L
+            if (m_pool) {
+              m_pool -> CalcEECJet(jet, csts, evt_weight, select);
+              break;
+            }
+#endif
+            m_calc.CalcEECJet(jet, csts, evt_weight, select);
+            break;
+          default:
+            {
+              const Kernel::ISA isa = m_calc.GetKernelISA();
+              m_calc.SetKernelISA((path == Type::Scalar) ? Kernel::Scalar : Kernel::GetBestISA());
+              m_calc.CalcEECJet(jet, csts, evt_weight, select);
+              m_calc.SetKernelISA(isa);
+            }
+            break;
+        }
+        return;
+
+      }  // end 'RunPath(Type::Path, Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
+
+      // ----------------------------------------------------------------------
+      //! Pick fastest path of a bucket
+      // ----------------------------------------------------------------------
+      void LockIn(const std::size_t ibkt) {
+
+        Bucket&    bkt  = m_buckets[ibkt];
+        double     best = -1.;
+        Type::Path pick = Type::SIMDRow;
+        for (std::size_t ipath = 0; ipath < NPaths; ++ipath) {
+          if ((bkt.ntrial[ipath] == 0) || (bkt.pairs[ipath] <= 0.)) continue;
+          const double cost = bkt.time[ipath] / bkt.pairs[ipath];
+          if ((best < 0.) || (cost < best)) {
+            best = cost;
+            pick = (Type::Path) ipath;
+          }
+        }
+        bkt.path = pick;
+
+        if (m_verbose) {
+          std::cout << "PHEnergyCorrelator::Dispatcher: using " << GetPathName(pick)
+                    << " path for " << GetBucketName(ibkt) << " cst.s\n"
+                    << "  " << GetTimingSummary(ibkt)
+                    << std::endl;
+        }
+        return;
+
+      }  // end 'LockIn(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Summarize timings of a bucket
+      // ----------------------------------------------------------------------
+      std::string GetTimingSummary(const std::size_t ibkt) const {
+
+        const Bucket& bkt = m_buckets[ibkt];
+
+        std::ostringstream summary;
+        for (std::size_t ipath = 0; ipath < NPaths; ++ipath) {
+          if (bkt.ntrial[ipath] == 0) continue;
+          if (!summary.str().empty()) summary << ", ";
+          summary << GetPathName((Type::Path) ipath) << " "
+                  << (1e9 * bkt.time[ipath] / bkt.pairs[ipath]) << " ns/pair";
+        }
+        return summary.str().empty() ? "no timings" : summary.str();
+
+      }  // end 'GetTimingSummary(std::size_t)'
+
+    public:
+
+      // ----------------------------------------------------------------------
+      //! Get name of a path
+      // ----------------------------------------------------------------------
+      static std::string GetPathName(const Type::Path path) {
+
+        switch (path) {
+          case Type::Scalar:
+            return "scalar";
+          case Type::SIMDRow:
+            return "simd-row";
+          case Type::Batched:
+            return "batched";
+          case Type::Threaded:
+            return "threaded";
+          default:
+            return "auto";
+        }
+
+      }  // end 'GetPathName(Type::Path)'
+
+      // ----------------------------------------------------------------------
+      //! Get bucket of a multiplicity
+      // ----------------------------------------------------------------------
+      static std::size_t GetBucket(const std::size_t ncst) {
+
+        std::size_t ibkt = 0;
+        while ((ibkt + 1 < NBuckets) && (ncst >= GetBucketLow(ibkt + 1))) ++ibkt;
+        return ibkt;
+
+      }  // end 'GetBucket(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Get lowest multiplicity of a bucket
+      // ----------------------------------------------------------------------
+      static std::size_t GetBucketLow(const std::size_t ibkt) {
+
+        return (ibkt == 0) ? 0 : ((std::size_t) 1 << (ibkt + 1));
+
+      }  // end 'GetBucketLow(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Get name of a bucket, e.g. "8 - 15"
+      // ----------------------------------------------------------------------
+      static std::string GetBucketName(const std::size_t ibkt) {
+
+        std::ostringstream name;
+        name << GetBucketLow(ibkt);
+        if (ibkt + 1 < NBuckets) {
+          name << " - " << GetBucketLow(ibkt + 1) - 1;
+        } else {
+          name << "+";
+        }
+        return name.str();
+
+      }  // end 'GetBucketName(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Getters
+      // ----------------------------------------------------------------------
+      Type::Path  GetPinnedPath() const {return m_pin;}
+      std::size_t GetWarmUp()     const {return m_nwarm;}
+
+      // ----------------------------------------------------------------------
+      //! Get no. of jets seen per (selected) multiplicity
+      // ----------------------------------------------------------------------
+      const std::vector<uint64_t>& GetMultiplicities() const {return m_mult;}
+
+      // ----------------------------------------------------------------------
+      //! Get path used for a multiplicity
+      // ----------------------------------------------------------------------
+      /*! Returns `Type::Auto` if its bucket is still warming up.
+       */
+      Type::Path GetPath(const std::size_t ncst) const {
+
+        return (m_pin != Type::Auto) ? m_pin : m_buckets[GetBucket(ncst)].path;
+
+      }  // end 'GetPath(std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Setters
+      // ----------------------------------------------------------------------
+      void SetVerbose(const bool verbose) {m_verbose = verbose;}
+      void SetWarmUp(const std::size_t nwarm) {m_nwarm = (nwarm > 0) ? nwarm : 1;}
+
+      // ----------------------------------------------------------------------
+      //! Pin a path
+      // ----------------------------------------------------------------------
+      /*! Every jet is sent down `path` no matter its multiplicity,
+       *  and nothing is timed. `Type::Auto` turns autotuning back on.
+       *  N.B. `Threaded` without a thread pool falls back to
+       *  `SIMDRow`, and `Batched` falls back to `CalcEECJet` for jets
+       *  which can't be batched.
+       */
+      void SetPath(const Type::Path path) {
+
+        m_pin = path;
+        return;
+
+      }  // end 'SetPath(Type::Path)'
+
+      // ----------------------------------------------------------------------
+      //! Do EEC calculation over all pairs of a jet
+      // ----------------------------------------------------------------------
+      /*! Same as `BasicCalculator::CalcEECJet`. The event (and jet)
+       *  should be set on `calc` as usual.
+       */
+      void CalcEECJet(
+        const Type::Jet& jet,
+        const std::vector<Type::Cst>& csts,
+        const double evt_weight = 1.0,
+        bool (*select)(const Type::Cst&) = NULL
+      ) {
+
+        // count selected cst.s
+        std::size_t ncst = csts.size();
+        if (select) {
+          ncst = 0;
+          for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+            if (select(csts[icst])) ++ncst;
+          }
+        }
+
+        // update multiplicity histogram
+        if (m_mult.size() <= ncst) m_mult.resize(ncst + 1, 0);
+        ++m_mult[ncst];
+
+        // after finishing, calc does everything
+        if (m_finished) {
+          m_calc.CalcEECJet(jet, csts, evt_weight, select);
+          return;
+        }
+
+        // if pinned, use pinned path
+        if (m_pin != Type::Auto) {
+          RunPath(m_pin, jet, csts, evt_weight, select);
+          return;
+        }
+
+        // if bucket is locked in (or there's nothing to time), use its path
+        const std::size_t ibkt = GetBucket(ncst);
+        Bucket&           bkt  = m_buckets[ibkt];
+        ++bkt.njet;
+        if ((bkt.path != Type::Auto) || (ncst == 0)) {
+          RunPath((bkt.path != Type::Auto) ? bkt.path : Type::SIMDRow, jet, csts, evt_weight, select);
+          return;
+        }
+
+        // otherwise time the candidate with the fewest jets so far
+        std::size_t itry = NPaths;
+        for (std::size_t ipath = 0; ipath < NPaths; ++ipath) {
+          if (!IsCandidate((Type::Path) ipath, ibkt)) continue;
+          if ((itry == NPaths) || (bkt.ntrial[ipath] < bkt.ntrial[itry])) itry = ipath;
+        }
+
+        // n.b. queued jets of the bucket are processed with the last
+        // batched trial so that their cost is counted
+        const Type::Path path  = (Type::Path) itry;
+        const double     start = GetTime();
+        RunPath(path, jet, csts, evt_weight, select);
+        if ((path == Type::Batched) && (bkt.ntrial[itry] + 1 >= m_nwarm)) {
+          m_calc.FlushEECBatches(GetBucketLow(ibkt), GetBucketLow(ibkt + 1));
+        }
+        bkt.time[itry]  += GetTime() - start;
+        bkt.pairs[itry] += 0.5 * ncst * (ncst + 1);
+        ++bkt.ntrial[itry];
+
+        // lock in fastest path once every candidate has warmed up
+        bool warm = true;
+        for (std::size_t ipath = 0; ipath < NPaths; ++ipath) {
+          if (IsCandidate((Type::Path) ipath, ibkt) && (bkt.ntrial[ipath] < m_nwarm)) warm = false;
+        }
+        if (warm) LockIn(ibkt);
+        return;
+
+      }  // end 'CalcEECJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
+
+      // ----------------------------------------------------------------------
+      //! Print chosen policy
+      // ----------------------------------------------------------------------
+      /*! Lists the no. of jets seen, the path used and the timings of
+       *  each path for every multiplicity bucket.
+       */
+      void PrintPolicy(std::ostream& os = std::cout) const {
+
+        os << "PHEnergyCorrelator::Dispatcher policy";
+        if (m_pin != Type::Auto) {
+          os << " (pinned to " << GetPathName(m_pin) << " path)";
+        }
+        os << ":\n";
+
+        for (std::size_t ibkt = 0; ibkt < NBuckets; ++ibkt) {
+          const Bucket& bkt = m_buckets[ibkt];
+          if (bkt.njet == 0) continue;
+          os << "  " << GetBucketName(ibkt) << " cst.s: " << bkt.njet << " jets, ";
+          if (bkt.path != Type::Auto) {
+            os << GetPathName(bkt.path) << " path";
+          } else {
+            os << "still warming up";
+          }
+          os << " (" << GetTimingSummary(ibkt) << ")\n";
+        }
+        os << std::flush;
+        return;
+
+      }  // end 'PrintPolicy(std::ostream&)'
+
+      // ----------------------------------------------------------------------
+      //! Process queued jets and merge thread shards into calculator
+      // ----------------------------------------------------------------------
+      /*! Should be called before `calc` is saved. Afterwards, all jets
+       *  are processed by `calc` directly.
+       */
+      void Finish() {
+
+        if (m_finished) return;
+
+        m_calc.FlushEECBatches();
+#if __cplusplus >= 201103L
+        if (m_pool) {
+          m_pool -> Finish();
+          delete m_pool;
+          m_pool = NULL;
+        }
+#endif
+        m_finished = true;
+
+        if (m_verbose) PrintPolicy(std::cout);
+        return;
+
+      }  // end 'Finish()'
+
+      // ----------------------------------------------------------------------
+      //! ctor accepting arguments
+      // ----------------------------------------------------------------------
+      /*! Histograms of `calc` should already be generated (i.e. `Init`
+       *  called). If `nthreads` > 1 (and compiled with c++11 or
+       *  later), a thread pool is started for the threaded path. Each
+       *  path is timed on `nwarm` jets of each bucket.
+       */
+      Dispatcher(
+        Calc& calc,
+        const std::size_t nthreads = 1,
+        const std::size_t nwarm = 32
+      ) : m_calc(calc), m_buckets(NBuckets) {
+
+        m_pin      = Type::Auto;
+        m_nwarm    = (nwarm > 0) ? nwarm : 1;
+        m_verbose  = true;
+        m_finished = false;
+
+#if __cplusplus >= 201103L
+        // n.b. a threshold of 0 sends every jet to the threads
+        m_pool = (nthreads > 1) ? new Parallel::JetPool<Calc>(calc, nthreads, 0) : NULL;
+#else
+        (void) nthreads;
+#endif
+
+      }  // end ctor(Calc&, std::size_t, std::size_t)
+
+      // ----------------------------------------------------------------------
+      //! dtor
+      // ----------------------------------------------------------------------
+      ~Dispatcher() {
+
+        Finish();
+
+      }  // end dtor
+
+  };  // end PHEnergyCorrelator::Dispatcher
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -25,6 +25,7 @@
 #include <TH3.h>
 #include <TString.h>
 // analysis components
+#include "PHCorrelatorAccumulator.h"
 #include "PHCorrelatorAnaTools.h"
 #include "PHCorrelatorAnaTypes.h"
 #include "PHCorrelatorBins.h"
@@ -68,21 +69,132 @@ namespace PHEnergyCorrelator {
         BDYD = 8   /*!< blue down, yellow down */
       };
 
+      // ----------------------------------------------------------------------
+      //! Offsets of 1D EEC histograms within their family block
+      // ----------------------------------------------------------------------
+      enum EEC1D {
+        EECStat     = 0,  /*!< R_{L} */
+        CollBStat   = 1,  /*!< blue collins angle */
+        CollYStat   = 2,  /*!< yellow collins angle */
+        BoerBStat   = 3,  /*!< blue boer-mulders angle */
+        BoerYStat   = 4,  /*!< yellow boer-mulders angle */
+        NEEC1D      = 5   /*!< no. of 1D EEC histograms */
+      };
+
+      // ----------------------------------------------------------------------
+      //! Offsets of 2D EEC histograms within their family block
+      // ----------------------------------------------------------------------
+      enum EEC2D {
+        CollBVsRStat = 0,  /*!< blue collins angle vs. R_{L} */
+        CollYVsRStat = 1,  /*!< yellow collins angle vs. R_{L} */
+        BoerBVsRStat = 2,  /*!< blue boer-mulders angle vs. R_{L} */
+        BoerYVsRStat = 3,  /*!< yellow boer-mulders angle vs. R_{L} */
+        NEEC2D       = 4   /*!< no. of 2D EEC histograms */
+      };
+
+      // ----------------------------------------------------------------------
+      //! Offsets of 1D E3C histograms within their family block
+      // ----------------------------------------------------------------------
+      enum E3C1D {
+        E3CStat = 0,  /*!< R_{L} */
+        NE3C1D  = 1   /*!< no. of 1D E3C histograms */
+      };
+
+      // ----------------------------------------------------------------------
+      //! Offsets of 3D E3C histograms within their family block
+      // ----------------------------------------------------------------------
+      enum E3C3D {
+        E3CXiThetaVsRStat = 0,  /*!< R_{L} vs. xi vs. theta */
+        NE3C3D            = 1   /*!< no. of 3D E3C histograms */
+      };
+
     private:
 
-      /* TODO
-       *   - GenerateE3CHists()
-       *   - GenerateLECHists()
+      // ----------------------------------------------------------------------
+      //! Histograms owned by a detached manager
+      // ----------------------------------------------------------------------
+      /*! Histograms of detached managers (e.g. clones) aren't owned by
+       *  a ROOT directory, so they're deleted along with the manager.
+       *  Copies of a manager share its histograms, so they're only
+       *  deleted with the last copy. N.B. copies should be made and
+       *  destroyed on one thread.
        */
+      class OwnedHists {
+
+        private:
+
+          // data members
+          std::vector<TH1*>* m_hists;
+          std::size_t*       m_nowners;
+
+          //! drop this copy, and delete histograms if it was the last
+          void Release() {
+            if (!m_nowners) return;
+            if (--(*m_nowners) == 0) {
+              for (std::size_t ihist = 0; ihist < m_hists -> size(); ++ihist) {
+                delete (*m_hists)[ihist];
+              }
+              delete m_hists;
+              delete m_nowners;
+            }
+            m_hists   = NULL;
+            m_nowners = NULL;
+          }
+
+        public:
+
+          //! take ownership of a histogram
+          void Add(TH1* hist) {
+            if (!m_nowners) {
+              m_hists   = new std::vector<TH1*>();
+              m_nowners = new std::size_t(1);
+            }
+            m_hists -> push_back(hist);
+          }
+
+          //! stop sharing histograms with other copies
+          void Reset() {Release();}
+
+          //! default ctor/dtor
+          OwnedHists() : m_hists(NULL), m_nowners(NULL) {};
+          ~OwnedHists() {Release();}
+
+          //! copy ctor
+          OwnedHists(const OwnedHists& other) : m_hists(other.m_hists), m_nowners(other.m_nowners) {
+            if (m_nowners) ++(*m_nowners);
+          }
+
+          //! copy assignment
+          OwnedHists& operator=(const OwnedHists& other) {
+            if (other.m_nowners) ++(*other.m_nowners);
+            Release();
+            m_hists   = other.m_hists;
+            m_nowners = other.m_nowners;
+            return *this;
+          }
+
+      };  // end OwnedHists
 
       // data members (options)
       bool m_do_eec_hist;
       bool m_do_e3c_hist;
+      bool m_do_enc_hist;
       bool m_do_lec_hist;
+      bool m_do_boer_hist;
       bool m_do_pt_bins;
       bool m_do_cf_bins;
       bool m_do_ch_bins;
       bool m_do_sp_bins;
+      bool m_do_finest;
+      bool m_did_reconstruct;
+      bool m_detached;
+
+      // data members (backend)
+      Type::Backend m_backend;
+      std::size_t   m_nstripes;
+
+      // data members (projected ENC order)
+      std::size_t m_enc_order;
 
       // data members (no. of bins)
       std::size_t m_nbins_pt;
@@ -100,6 +212,30 @@ namespace PHEnergyCorrelator {
       std::map<unsigned int, TH2D*> m_hist_2d;
       std::map<unsigned int, TH3D*> m_hist_3d;
 
+      // data members (dense histogram tables)
+      //   - n.b. these hold the same histograms as the maps above,
+      //     arranged as [family][index] so that they can be accessed
+      //     without building names during filling
+      std::vector<TH1D*> m_table_1d;
+      std::vector<TH2D*> m_table_2d;
+      std::vector<TH3D*> m_table_3d;
+
+      // data members (histograms to delete, if detached)
+      OwnedHists m_owned;
+
+      // data members (flat accumulators, one per family)
+      std::vector<Accumulator> m_acc_1d;
+      std::vector<Accumulator> m_acc_2d;
+      std::vector<Accumulator> m_acc_3d;
+
+      // data members (first family of each histogram block)
+      std::size_t m_eec_fam_1d;
+      std::size_t m_eec_fam_2d;
+      std::size_t m_e3c_fam_1d;
+      std::size_t m_e3c_fam_3d;
+      std::size_t m_enc_fam_1d;
+      std::size_t m_lec_fam_1d;
+
       // data members (bins)
       Bins m_bins;
 
@@ -257,31 +393,287 @@ namespace PHEnergyCorrelator {
         const std::string name = MakeHistName(base, tag);
         return HashString( name.data() );
 
+      }  // end 'MakeHashedName(std::string&, std::string&)'
+
+      // ----------------------------------------------------------------------
+      //! Flatten a histogram index into a position in the dense tables
+      // ----------------------------------------------------------------------
+      /*! The (pt, cf, chrg, spin) indices are treated as digits of a
+       *  mixed-radix number. The order matches the one used to generate
+       *  the index tags in `GenerateIndexTags()`, so the flattened index
+       *  is also the position of the corresponding tag in `m_index_tags`.
+       */
+      std::size_t FlattenIndex(const Type::HistIndex& index) const {
+
+        return (
+          (
+            (index.pt * m_nbins_cf + index.cf) * (m_nbins_ch + 1) + index.chrg
+          ) * m_nbins_sp
+        ) + index.spin;
+
+      }  // end 'FlattenIndex(Type::HistIndex&)'
+
+      // ----------------------------------------------------------------------
+      //! Get histograms from the dense tables
+      // ----------------------------------------------------------------------
+      TH1D* TableHist1D(const std::size_t family, const std::size_t iflat) const {
+        return m_table_1d[(family * m_index_tags.size()) + iflat];
+      }
+
+      TH2D* TableHist2D(const std::size_t family, const std::size_t iflat) const {
+        return m_table_2d[(family * m_index_tags.size()) + iflat];
+      }
+
+      TH3D* TableHist3D(const std::size_t family, const std::size_t iflat) const {
+        return m_table_3d[(family * m_index_tags.size()) + iflat];
       }
 
+      // ----------------------------------------------------------------------
+      //! Find cells of EEC accumulators for a pair
+      // ----------------------------------------------------------------------
+      /*! All EEC families share the same R_{L} and angle axes, so
+       *  each value is looked up once and the resulting bins are
+       *  combined into cells of the 2D accumulators.
+       */
+      void FindEECCells(
+        const Type::HistContent& content,
+        std::size_t (&cell_1d)[NEEC1D],
+        std::size_t (&cell_2d)[NEEC2D]
+      ) const {
+
+        // find bins along each axis
+        cell_1d[EECStat]   = m_acc_1d[m_eec_fam_1d + EECStat].FindBinX(content.rl);
+        cell_1d[CollBStat] = m_acc_1d[m_eec_fam_1d + CollBStat].FindBinX(content.phiCollB);
+        cell_1d[CollYStat] = m_acc_1d[m_eec_fam_1d + CollYStat].FindBinX(content.phiCollY);
+        if (m_do_boer_hist) {
+          cell_1d[BoerBStat] = m_acc_1d[m_eec_fam_1d + BoerBStat].FindBinX(content.phiBoerB);
+          cell_1d[BoerYStat] = m_acc_1d[m_eec_fam_1d + BoerYStat].FindBinX(content.phiBoerY);
+        }
+
+        // then combine them into 2d cells
+        cell_2d[CollBVsRStat] = m_acc_2d[m_eec_fam_2d + CollBVsRStat].GetCell(cell_1d[EECStat], cell_1d[CollBStat]);
+        cell_2d[CollYVsRStat] = m_acc_2d[m_eec_fam_2d + CollYVsRStat].GetCell(cell_1d[EECStat], cell_1d[CollYStat]);
+        if (m_do_boer_hist) {
+          cell_2d[BoerBVsRStat] = m_acc_2d[m_eec_fam_2d + BoerBVsRStat].GetCell(cell_1d[EECStat], cell_1d[BoerBStat]);
+          cell_2d[BoerYVsRStat] = m_acc_2d[m_eec_fam_2d + BoerYVsRStat].GetCell(cell_1d[EECStat], cell_1d[BoerYStat]);
+        }
+        return;
+
+      }  // end 'FindEECCells(Type::HistContent&, std::size_t[], std::size_t[])'
+
+      // ----------------------------------------------------------------------
+      //! Fill cells of EEC accumulators
+      // ----------------------------------------------------------------------
+      void FillEECCells(
+        const std::size_t iflat,
+        const std::size_t (&cell_1d)[NEEC1D],
+        const std::size_t (&cell_2d)[NEEC2D],
+        const double weight
+      ) {
+
+        // n.b. boer-mulders histograms come last
+        const std::size_t nhist_1d = m_do_boer_hist ? NEEC1D : BoerBStat;
+        const std::size_t nhist_2d = m_do_boer_hist ? NEEC2D : BoerBVsRStat;
+
+        // n.b. angle histograms are unweighted
+        m_acc_1d[m_eec_fam_1d + EECStat].FillCell(iflat, cell_1d[EECStat], weight);
+        for (std::size_t ihist = CollBStat; ihist < nhist_1d; ++ihist) {
+          m_acc_1d[m_eec_fam_1d + ihist].FillCell(iflat, cell_1d[ihist], 1.0);
+        }
+        for (std::size_t ihist = 0; ihist < nhist_2d; ++ihist) {
+          m_acc_2d[m_eec_fam_2d + ihist].FillCell(iflat, cell_2d[ihist], weight);
+        }
+        return;
+
+      }  // end 'FillEECCells(std::size_t, std::size_t[], std::size_t[], double)'
+
+      // ----------------------------------------------------------------------
+      //! Find cells of E3C accumulators for a triplet
+      // ----------------------------------------------------------------------
+      void FindE3CCells(
+        const Type::HistContent& content,
+        std::size_t (&cell_1d)[NE3C1D],
+        std::size_t (&cell_3d)[NE3C3D]
+      ) const {
+
+        const Accumulator& shape = m_acc_3d[m_e3c_fam_3d + E3CXiThetaVsRStat];
+
+        cell_1d[E3CStat]           = m_acc_1d[m_e3c_fam_1d + E3CStat].FindBinX(content.rl);
+        cell_3d[E3CXiThetaVsRStat] = shape.GetCell(
+          cell_1d[E3CStat],
+          shape.FindBinY(content.xi),
+          shape.FindBinZ(content.theta)
+        );
+        return;
+
+      }  // end 'FindE3CCells(Type::HistContent&, std::size_t[], std::size_t[])'
+
+      // ----------------------------------------------------------------------
+      //! Fill cells of E3C accumulators
+      // ----------------------------------------------------------------------
+      void FillE3CCells(
+        const std::size_t iflat,
+        const std::size_t (&cell_1d)[NE3C1D],
+        const std::size_t (&cell_3d)[NE3C3D],
+        const double weight
+      ) {
+
+        for (std::size_t ihist = 0; ihist < NE3C1D; ++ihist) {
+          m_acc_1d[m_e3c_fam_1d + ihist].FillCell(iflat, cell_1d[ihist], weight);
+        }
+        for (std::size_t ihist = 0; ihist < NE3C3D; ++ihist) {
+          m_acc_3d[m_e3c_fam_3d + ihist].FillCell(iflat, cell_3d[ihist], weight);
+        }
+        return;
+
+      }  // end 'FillE3CCells(std::size_t, std::size_t[], std::size_t[], double)'
+
+      // ----------------------------------------------------------------------
+      //! Register a histogram in a hashed map
+      // ----------------------------------------------------------------------
+      /*! Throws an error if the hashed name is already taken: this
+       *  catches both duplicate names and hash collisions when
+       *  histograms are created, rather than letting 2 histograms
+       *  silently share a key. If detached, the manager takes
+       *  ownership of the histogram.
+       */
+      template <typename THN> void RegisterHist(
+        std::map<unsigned int, THN*>& hists,
+        std::vector<THN*>& table,
+        const std::size_t position,
+        THN* hist
+      ) {
+
+        const unsigned int key = HashString( hist -> GetName() );
+        if (hists.count(key) >= 1) {
+          assert(hists.count(key) == 0);
+        }
+        hists[key]      = hist;
+        table[position] = hist;
+        if (m_detached) m_owned.Add(hist);
+        return;
+
+      }  // end 'RegisterHist(std::map<unsigned int, THN*>&, std::vector<THN*>&, std::size_t, THN*)'
+
+      // ----------------------------------------------------------------------
+      //! Flag "hot" histograms of a family
+      // ----------------------------------------------------------------------
+      /*! These are the histograms integrated over pt, charge and spin,
+       *  which every pair of a given CF bin fills. With the atomic
+       *  backend, these are striped across threads.
+       */
+      std::vector<bool> GetHotHists() const {
+
+        std::vector<bool> hot(m_index_tags.size(), false);
+        for (std::size_t icf = 0; icf < m_nbins_cf; ++icf) {
+          hot[ FlattenIndex( Type::HistIndex(m_nbins_pt, icf, m_nbins_ch, Int) ) ] = true;
+        }
+        return hot;
+
+      }  // end 'GetHotHists()'
+
+      // ----------------------------------------------------------------------
+      //! Make the definition of a specific histogram in a family
+      // ----------------------------------------------------------------------
+      Histogram MakeIndexedDef(const Histogram& def, const std::size_t index) const {
+
+        Histogram hist = def;
+        hist.PrependToName( m_hist_pref );
+        hist.AppendToName( MakeHistSuffix(m_index_tags[index]) );
+        return hist;
+
+      }  // end 'MakeIndexedDef(Histogram&, std::size_t)'
+
       // ----------------------------------------------------------------------
       //! Make histograms out of a list of definitions
       // ----------------------------------------------------------------------
-      void MakeHistograms(const std::vector<Histogram>& defs, const int dim) {
+      /*! Each definition makes up one "family" of histograms, i.e. one
+       *  histogram per index tag. Families are appended to the dense
+       *  table of the relevant dimension, and the position of the first
+       *  one is returned.
+       */
+      std::size_t MakeHistograms(
+        const std::vector<Histogram>& defs,
+        const int dim,
+        const bool weighted = true
+      ) {
+
+        // grab position of 1st family
+        const std::size_t ntags = m_index_tags.size();
+        std::size_t       first = 0;
+        switch (dim) {
+          case 1:
+            first = m_table_1d.size() / ntags;
+            m_table_1d.resize(m_table_1d.size() + (defs.size() * ntags), NULL);
+            break;
+          case 2:
+            first = m_table_2d.size() / ntags;
+            m_table_2d.resize(m_table_2d.size() + (defs.size() * ntags), NULL);
+            break;
+          case 3:
+            first = m_table_3d.size() / ntags;
+            m_table_3d.resize(m_table_3d.size() + (defs.size() * ntags), NULL);
+            break;
+          default:
+            assert((dim >= 1) && (dim <= 3));
+            break;
+        }
+
+        // if using flat backend, only create accumulators: ROOT
+        // histograms will be created when materializing
+        if (UsesAccumulators()) {
+          const std::vector<bool> hot = GetHotHists();
+          for (std::size_t ihist = 0; ihist < defs.size(); ++ihist) {
+            switch (dim) {
+              case 1:
+                m_acc_1d.push_back( Accumulator(defs[ihist], ntags, 1, weighted) );
+                break;
+              case 2:
+                m_acc_2d.push_back( Accumulator(defs[ihist], ntags, 2, weighted) );
+                break;
+              case 3:
+                m_acc_3d.push_back( Accumulator(defs[ihist], ntags, 3, weighted) );
+                break;
+              default:
+                assert((dim >= 1) && (dim <= 3));
+                break;
+            }
+
+            // if atomic backend, switch to shared contents
+            if (m_backend == Type::Atomic) {
+              switch (dim) {
+                case 1:
+                  m_acc_1d.back().MakeAtomic(hot, m_nstripes);
+                  break;
+                case 2:
+                  m_acc_2d.back().MakeAtomic(hot, m_nstripes);
+                  break;
+                case 3:
+                  m_acc_3d.back().MakeAtomic(hot, m_nstripes);
+                  break;
+              }
+            }
+          }
+          return first;
+        }
 
         for (std::size_t ihist = 0; ihist < defs.size(); ++ihist) {
-          for (std::size_t index = 0; index < m_index_tags.size(); ++index) {
+          for (std::size_t index = 0; index < ntags; ++index) {
 
             // grab definition, adjust name
-            Histogram hist = defs[ihist];
-            hist.PrependToName( m_hist_pref );
-            hist.AppendToName( MakeHistSuffix(m_index_tags[index]) );
+            const Histogram   hist     = MakeIndexedDef(defs[ihist], index);
+            const std::size_t position = ((first + ihist) * ntags) + index;
 
             // create histogram, set errors
             switch (dim) {
               case 1:
-                m_hist_1d[ HashString(hist.GetName().data()) ] = hist.MakeTH1();
+                RegisterHist(m_hist_1d, m_table_1d, position, hist.MakeTH1());
                 break;
               case 2:
-                m_hist_2d[ HashString(hist.GetName().data()) ] = hist.MakeTH2();
+                RegisterHist(m_hist_2d, m_table_2d, position, hist.MakeTH2());
                 break;
               case 3:
-                m_hist_3d[ HashString(hist.GetName().data()) ] = hist.MakeTH3();
+                RegisterHist(m_hist_3d, m_table_3d, position, hist.MakeTH3());
                 break;
               default:
                 assert((dim >= 1) && (dim <= 3));
@@ -289,9 +681,61 @@ namespace PHEnergyCorrelator {
             }
           }
         }
+        return first;
+
+      }  // end 'MakeHistograms(std::vector<Histogram>&, uint32_t, bool)'
+
+      // ----------------------------------------------------------------------
+      //! Copy flat accumulators into ROOT histograms
+      // ----------------------------------------------------------------------
+      /*! Creates ROOT histograms the 1st time it's called, and after
+       *  that overwrites their contents with the current ones.
+       */
+      void MaterializeHists() {
+
+        // if detached, don't register histograms in current directory
+        const bool add_dir = TH1::AddDirectoryStatus();
+        if (m_detached) TH1::AddDirectory(false);
+
+        const std::size_t ntags = m_index_tags.size();
+        for (std::size_t ifam = 0; ifam < m_acc_1d.size(); ++ifam) {
+          for (std::size_t index = 0; index < ntags; ++index) {
+            const std::size_t position = (ifam * ntags) + index;
+            if (!m_table_1d[position]) {
+              const Histogram hist = MakeIndexedDef(m_acc_1d[ifam].GetDef(), index);
+              RegisterHist(m_hist_1d, m_table_1d, position, hist.MakeTH1());
+            }
+            m_acc_1d[ifam].CopyTo(index, m_table_1d[position]);
+          }
+        }
+        for (std::size_t ifam = 0; ifam < m_acc_2d.size(); ++ifam) {
+          for (std::size_t index = 0; index < ntags; ++index) {
+            const std::size_t position = (ifam * ntags) + index;
+            if (!m_table_2d[position]) {
+              const Histogram hist = MakeIndexedDef(m_acc_2d[ifam].GetDef(), index);
+              RegisterHist(m_hist_2d, m_table_2d, position, hist.MakeTH2());
+            }
+            m_acc_2d[ifam].CopyTo(index, m_table_2d[position]);
+          }
+        }
+        for (std::size_t ifam = 0; ifam < m_acc_3d.size(); ++ifam) {
+          for (std::size_t index = 0; index < ntags; ++index) {
+            const std::size_t position = (ifam * ntags) + index;
+            if (!m_table_3d[position]) {
+              const Histogram hist = MakeIndexedDef(m_acc_3d[ifam].GetDef(), index);
+              RegisterHist(m_hist_3d, m_table_3d, position, hist.MakeTH3());
+            }
+            m_acc_3d[ifam].CopyTo(index, m_table_3d[position]);
+          }
+        }
+
+        // contents are back to the raw sums, so integrated
+        // histograms need to be reconstructed again
+        m_did_reconstruct = false;
+        TH1::AddDirectory(add_dir);
         return;
 
-      }  // end 'MakeHistograms(std::vector<Histogram>&, uint32_t)'
+      }  // end 'MaterializeHists()'
 
       // ----------------------------------------------------------------------
       //! Generate tags for bins
@@ -347,22 +791,26 @@ namespace PHEnergyCorrelator {
         const std::string boerY_title("#varphi_{Y}^{boers-mulder}");
 
         // 1d histogram definitions
+        //   - n.b. angle histograms are unweighted
         std::vector<Histogram> def_1d;
+        std::vector<Histogram> def_1d_unweighted;
         def_1d.push_back(
           Histogram("EECStat", "", "R_{L}", m_bins.Get("side"))
         );
-        def_1d.push_back(
+        def_1d_unweighted.push_back(
           Histogram("CollinsBlueStat", "", collB_title, m_bins.Get("angle"))
         );
-        def_1d.push_back(
+        def_1d_unweighted.push_back(
           Histogram("CollinsYellStat", "", collY_title, m_bins.Get("angle"))
         );
-        def_1d.push_back(
-          Histogram("BoerMuldersBlueStat", "", boerB_title, m_bins.Get("angle"))
-        );
-        def_1d.push_back(
-          Histogram("BoerMuldersYellStat", "", boerY_title, m_bins.Get("angle"))
-        );
+        if (m_do_boer_hist) {
+          def_1d_unweighted.push_back(
+            Histogram("BoerMuldersBlueStat", "", boerB_title, m_bins.Get("angle"))
+          );
+          def_1d_unweighted.push_back(
+            Histogram("BoerMuldersYellStat", "", boerY_title, m_bins.Get("angle"))
+          );
+        }
 
         // vectors of binnings for 2d histograms
         std::vector<Binning> angleXside_bins;
@@ -391,19 +839,281 @@ namespace PHEnergyCorrelator {
         def_2d.push_back(
           Histogram("CollinsYellVsRStat", "", collXsideY_titles, angleXside_bins)
         );
-        def_2d.push_back(
-          Histogram("BoerMuldersBlueVsRStat", "", boerXsideB_titles, angleXside_bins)
+        if (m_do_boer_hist) {
+          def_2d.push_back(
+            Histogram("BoerMuldersBlueVsRStat", "", boerXsideB_titles, angleXside_bins)
+          );
+          def_2d.push_back(
+            Histogram("BoerMuldersYellVsRStat", "", boerXsideY_titles, angleXside_bins)
+          );
+        }
+
+        // create histograms
+        //   - n.b. the order of the definitions above
+        //     must match the EEC1D and EEC2D enums, and
+        //     the boer-mulders ones must come last
+        m_eec_fam_1d = MakeHistograms(def_1d, 1);
+        m_eec_fam_2d = MakeHistograms(def_2d, 2);
+        MakeHistograms(def_1d_unweighted, 1, false);
+        return;
+
+      }  // end 'GenerateEECHists()'
+
+      // ----------------------------------------------------------------------
+      //! Generate 3-point histograms
+      // ----------------------------------------------------------------------
+      void GenerateE3CHists() {
+
+        // 1d histogram definitions
+        std::vector<Histogram> def_1d;
+        def_1d.push_back(
+          Histogram("E3CStat", "", "R_{L}", m_bins.Get("side"))
         );
-        def_2d.push_back(
-          Histogram("BoerMuldersYellVsRStat", "", boerXsideY_titles, angleXside_bins)
+
+        // binning and axis titles for 3d histograms
+        std::vector<Binning> sideXxiXtheta_bins;
+        sideXxiXtheta_bins.push_back(m_bins.Get("side"));
+        sideXxiXtheta_bins.push_back(m_bins.Get("xi"));
+        sideXxiXtheta_bins.push_back(m_bins.Get("theta"));
+
+        std::vector<std::string> sideXxiXtheta_titles;
+        sideXxiXtheta_titles.push_back("R_{L}");
+        sideXxiXtheta_titles.push_back("#xi");
+        sideXxiXtheta_titles.push_back("#theta");
+
+        // 3d histogram definitions
+        std::vector<Histogram> def_3d;
+        def_3d.push_back(
+          Histogram("E3CXiThetaVsRStat", "", sideXxiXtheta_titles, sideXxiXtheta_bins)
         );
 
         // create histograms
-        MakeHistograms(def_1d, 1);
-        MakeHistograms(def_2d, 2);
+        //   - n.b. the order of the definitions above
+        //     must match the E3C1D and E3C3D enums
+        m_e3c_fam_1d = MakeHistograms(def_1d, 1);
+        m_e3c_fam_3d = MakeHistograms(def_3d, 3);
         return;
 
-      }  // end 'GenerateEECHists()'
+      }  // end 'GenerateE3CHists()'
+
+      // ----------------------------------------------------------------------
+      //! Generate projected N-point histograms
+      // ----------------------------------------------------------------------
+      void GenerateENCHists() {
+
+        // title reflects order of correlator
+        TString title("E");
+        title += m_enc_order;
+        title += "C";
+
+        // 1d histogram definitions
+        std::vector<Histogram> def_1d;
+        def_1d.push_back(
+          Histogram("ENCStat", title.Data(), "R_{L}", m_bins.Get("side"))
+        );
+
+        // create histograms
+        m_enc_fam_1d = MakeHistograms(def_1d, 1);
+        return;
+
+      }  // end 'GenerateENCHists()'
+
+      // ----------------------------------------------------------------------
+      //! Generate leading-hadron histograms
+      // ----------------------------------------------------------------------
+      void GenerateLECHists() {
+
+        // 1d histogram definitions
+        std::vector<Histogram> def_1d;
+        def_1d.push_back(
+          Histogram("LECStat", "", "R_{L}", m_bins.Get("side"))
+        );
+
+        // create histograms
+        m_lec_fam_1d = MakeHistograms(def_1d, 1);
+        return;
+
+      }  // end 'GenerateLECHists()'
+
+      // ----------------------------------------------------------------------
+      //! Double a histogram's contents, errors, and entries
+      // ----------------------------------------------------------------------
+      /*! Equivalent to filling every entry a 2nd time. Sum of weights
+       *  squared are doubled directly so that this is exact.
+       */
+      template <typename THN> void DoubleHist(THN* hist) const {
+
+        for (int ibin = 0; ibin < hist -> GetNcells(); ++ibin) {
+          hist -> SetBinContent(ibin, 2.0 * hist -> GetBinContent(ibin));
+          if (hist -> GetSumw2N() > 0) {
+            hist -> GetSumw2() -> fArray[ibin] *= 2.0;
+          }
+        }
+        hist -> SetEntries(2.0 * hist -> GetEntries());
+        return;
+
+      }  // end 'DoubleHist(THN*)'
+
+      // ----------------------------------------------------------------------
+      //! Reconstruct integrated histograms of one family from finest bins
+      // ----------------------------------------------------------------------
+      /*! When only the finest bins are filled, each pair lands in exactly
+       *  one (pt, cf, chrg, spin) histogram:
+       *    - pt/charge: the jet's bin (or the integrated "bin" if not
+       *      binning on pt/charge);
+       *    - spin: blue x yellow for pp patterns, blue for pAu
+       *      patterns, and integrated for anything else.
+       *  Since histogram contents and errors are additive, everything
+       *  else can be summed up from these. This reproduces what filling
+       *  every index returned by `Calculator::GetHistIndices` gives,
+       *  up to the order in which floating-point sums are done.
+       */
+      template <typename THN> void ReconstructFamily(THN** hists) const {
+
+        // no. of bins with integrated "bins"
+        const std::size_t nbins_pt_use = m_nbins_pt + 1;
+        const std::size_t nbins_ch_use = m_nbins_ch + 1;
+
+        // (1) single-beam and spin-integrated hists from
+        //     blue x yellow and blue-only (pAu) hists
+        if (m_do_sp_bins) {
+          for (std::size_t ipt = 0; ipt < nbins_pt_use; ++ipt) {
+            for (std::size_t icf = 0; icf < m_nbins_cf; ++icf) {
+              for (std::size_t ich = 0; ich < nbins_ch_use; ++ich) {
+
+                // grab histograms for each spin
+                THN* sp[9];
+                for (std::size_t isp = 0; isp < m_nbins_sp; ++isp) {
+                  sp[isp] = hists[FlattenIndex( Type::HistIndex(ipt, icf, ich, isp) )];
+                }
+
+                // blue x yellow --> blue
+                sp[BU] -> Add(sp[BUYU]);
+                sp[BU] -> Add(sp[BUYD]);
+                sp[BD] -> Add(sp[BDYU]);
+                sp[BD] -> Add(sp[BDYD]);
+
+                // blue x yellow --> yellow
+                sp[YU] -> Add(sp[BUYU]);
+                sp[YU] -> Add(sp[BDYU]);
+                sp[YD] -> Add(sp[BUYD]);
+                sp[YD] -> Add(sp[BDYD]);
+
+                // blue --> integrated
+                sp[Int] -> Add(sp[BU]);
+                sp[Int] -> Add(sp[BD]);
+              }
+            }
+          }
+        }  // end spin reconstruction
+
+        // (2) integrated pt/charge hists from binned ones
+        for (std::size_t icf = 0; icf < m_nbins_cf; ++icf) {
+          for (std::size_t isp = 0; isp < m_nbins_sp; ++isp) {
+            for (std::size_t ipt = 0; ipt < m_nbins_pt; ++ipt) {
+              for (std::size_t ich = 0; ich < m_nbins_ch; ++ich) {
+
+                // binned pt & charge --> integrated pt, binned charge
+                hists[FlattenIndex( Type::HistIndex(m_nbins_pt, icf, ich, isp) )] -> Add(
+                  hists[FlattenIndex( Type::HistIndex(ipt, icf, ich, isp) )]
+                );
+
+                // binned pt & charge --> binned pt, integrated charge
+                hists[FlattenIndex( Type::HistIndex(ipt, icf, m_nbins_ch, isp) )] -> Add(
+                  hists[FlattenIndex( Type::HistIndex(ipt, icf, ich, isp) )]
+                );
+              }
+            }
+
+            // integrated charge --> integrated pt & charge
+            if (m_nbins_pt > 0) {
+              for (std::size_t ipt = 0; ipt < m_nbins_pt; ++ipt) {
+                hists[FlattenIndex( Type::HistIndex(m_nbins_pt, icf, m_nbins_ch, isp) )] -> Add(
+                  hists[FlattenIndex( Type::HistIndex(ipt, icf, m_nbins_ch, isp) )]
+                );
+              }
+            } else {
+              // if pt isn't binned, integrated pt is already
+              // filled for each charge bin
+              for (std::size_t ich = 0; ich < m_nbins_ch; ++ich) {
+                hists[FlattenIndex( Type::HistIndex(m_nbins_pt, icf, m_nbins_ch, isp) )] -> Add(
+                  hists[FlattenIndex( Type::HistIndex(m_nbins_pt, icf, ich, isp) )]
+                );
+              }
+            }
+          }
+        }  // end pt/charge reconstruction
+
+        // (3) if pt or charge isn't binned, `GetHistIndices` returns
+        //     the same index more than once and each histogram gets
+        //     filled once per copy; mimic that here
+        const std::size_t ntags  = m_index_tags.size();
+        const std::size_t ncopy  = (m_nbins_pt == 0 ? 2 : 1) * (m_nbins_ch == 0 ? 2 : 1);
+        for (std::size_t icopy = 1; icopy < ncopy; icopy *= 2) {
+          for (std::size_t index = 0; index < ntags; ++index) {
+            DoubleHist(hists[index]);
+          }
+        }
+        return;
+
+      }  // end 'ReconstructFamily(THN**)'
+
+      // ----------------------------------------------------------------------
+      //! Reconstruct integrated histograms from finest bins
+      // ----------------------------------------------------------------------
+      void ReconstructHists() {
+
+        const std::size_t ntags = m_index_tags.size();
+        for (std::size_t ihist = 0; ihist < m_table_1d.size(); ihist += ntags) {
+          ReconstructFamily(&m_table_1d[ihist]);
+        }
+        for (std::size_t ihist = 0; ihist < m_table_2d.size(); ihist += ntags) {
+          ReconstructFamily(&m_table_2d[ihist]);
+        }
+        for (std::size_t ihist = 0; ihist < m_table_3d.size(); ihist += ntags) {
+          ReconstructFamily(&m_table_3d[ihist]);
+        }
+        m_did_reconstruct = true;
+        return;
+
+      }  // end 'ReconstructHists()'
+
+      // ----------------------------------------------------------------------
+      //! Bring histograms up to date before they're read
+      // ----------------------------------------------------------------------
+      /*! Copies flat accumulators into the histograms, and then, if
+       *  only finest bins were filled, sums up the rest. N.B. with the
+       *  ROOT backend the sums are done in place and only once, so
+       *  histograms can't be filled after they were first read or
+       *  saved (see `CheckFillable`).
+       */
+      void UpdateHists() {
+
+        // if using flat backend, copy contents into histograms
+        if (UsesAccumulators()) MaterializeHists();
+
+        // if only finest bins were filled, sum up the rest
+        if (m_do_finest && !m_did_reconstruct) ReconstructHists();
+        return;
+
+      }  // end 'UpdateHists()'
+
+      // ----------------------------------------------------------------------
+      //! Throw error if ROOT histograms were already reconstructed
+      // ----------------------------------------------------------------------
+      /*! With the ROOT backend, integrated histograms are summed up in
+       *  place from the finest bins (and finest bins may be doubled),
+       *  which can't be undone. Any later fills would be missing from
+       *  the integrated histograms, so they're not allowed.
+       */
+      void CheckFillable() const {
+
+        if (m_did_reconstruct) {
+          assert(!m_did_reconstruct);
+        }
+        return;
+
+      }  // end 'CheckFillable()'
 
 #if DO_WIDTH_CALC
       // ----------------------------------------------------------------------
@@ -449,9 +1159,17 @@ namespace PHEnergyCorrelator {
       bool        GetDoCFJetBins()  const {return m_do_cf_bins;}
       bool        GetDoChargeBins() const {return m_do_ch_bins;}
       bool        GetDoSpinBins()   const {return m_do_sp_bins;}
+      bool        GetDoFinestOnly() const {return m_do_finest;}
+      bool        GetDetached()     const {return m_detached;}
+      Type::Backend GetBackend()    const {return m_backend;}
+      std::size_t GetNStripes()     const {return m_nstripes;}
+      bool        UsesAccumulators() const {return m_backend != Type::Root;}
       bool        GetDoEECHists()   const {return m_do_eec_hist;}
       bool        GetDoE3CHists()   const {return m_do_e3c_hist;}
+      bool        GetDoENCHists()   const {return m_do_enc_hist;}
+      std::size_t GetENCOrder()     const {return m_enc_order;}
       bool        GetDoLECHists()   const {return m_do_lec_hist;}
+      bool        GetDoBoerHists()  const {return m_do_boer_hist;}
 
       // ----------------------------------------------------------------------
       //! Setters
@@ -459,7 +1177,12 @@ namespace PHEnergyCorrelator {
       void SetHistTag(const std::string& tag) {m_hist_tag    = tag;}
       void SetDoEECHists(const bool dohists)  {m_do_eec_hist = dohists;}
       void SetDoE3CHists(const bool dohists)  {m_do_e3c_hist = dohists;}
+      void SetDoENCHists(const bool dohists)  {m_do_enc_hist = dohists;}
+      void SetENCOrder(const std::size_t order) {m_enc_order = order;}
       void SetDoLECHists(const bool dohists)  {m_do_lec_hist = dohists;}
+      void SetDoBoerHists(const bool dohists) {m_do_boer_hist = dohists;}
+      void SetBackend(const Type::Backend backend) {m_backend = backend;}
+      void SetNStripes(const std::size_t nstripes) {m_nstripes = nstripes;}
 
       // ----------------------------------------------------------------------
       //! Bin on jet pt
@@ -504,6 +1227,21 @@ namespace PHEnergyCorrelator {
 
       }  // end 'DoSpinBins()'
 
+      // ----------------------------------------------------------------------
+      //! Only fill finest bins
+      // ----------------------------------------------------------------------
+      /*! If set, only the fully differential (pt, cf, chrg, spin)
+       *  histogram is filled for each pair. Integrated pt/charge and
+       *  single-beam/integrated spin histograms are then summed up
+       *  when histograms are saved or retrieved (see `UpdateHists`).
+       */
+      void DoFinestOnly(const bool finest) {
+
+        m_do_finest = finest;
+        return;
+
+      }  // end 'DoFinestOnly(bool)'
+
       // ----------------------------------------------------------------------
       //! Generate histograms
       // ----------------------------------------------------------------------
@@ -526,9 +1264,16 @@ namespace PHEnergyCorrelator {
         TH2::SetDefaultSumw2(true);
         TH3::SetDefaultSumw2(true);
 
+        // if detached, don't register histograms in current directory
+        const bool add_dir = TH1::AddDirectoryStatus();
+        if (m_detached) TH1::AddDirectory(false);
+
         // finally generate appropriate histograms
-        //   - TODO add others when ready
         if (m_do_eec_hist) GenerateEECHists();
+        if (m_do_e3c_hist) GenerateE3CHists();
+        if (m_do_enc_hist) GenerateENCHists();
+        if (m_do_lec_hist) GenerateLECHists();
+        TH1::AddDirectory(add_dir);
         return;
 
       }  // end 'GenerateHists()'
@@ -538,38 +1283,358 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       void FillEECHists(const Type::HistIndex& index, const Type::HistContent& content) {
 
-        // grab hist tag from index
-        const std::string tag = MakeIndexTag(index);
+        // get position of histograms in tables
+        const std::size_t iflat = FlattenIndex(index);
+
+        // if using flat backend, fill accumulators
+        if (UsesAccumulators()) {
+          std::size_t cell_1d[NEEC1D];
+          std::size_t cell_2d[NEEC2D];
+          FindEECCells(content, cell_1d, cell_2d);
+          FillEECCells(iflat, cell_1d, cell_2d, content.weight);
+          return;
+        }
+
+        // throw error if integrated histograms were already reconstructed
+        CheckFillable();
 
         // fill 1d histograms
-        m_hist_1d[ MakeHashedName("EECStat", tag) ] -> Fill(content.rl, content.weight);
-        m_hist_1d[ MakeHashedName("CollinsBlueStat", tag) ] -> Fill(content.phiCollB);
-        m_hist_1d[ MakeHashedName("CollinsYellStat", tag) ] -> Fill(content.phiCollY);
-        m_hist_1d[ MakeHashedName("BoerMuldersBlueStat", tag) ] -> Fill(content.phiBoerB);
-        m_hist_1d[ MakeHashedName("BoerMuldersYellStat", tag) ] -> Fill(content.phiBoerY);
+        TableHist1D(m_eec_fam_1d + EECStat, iflat)   -> Fill(content.rl, content.weight);
+        TableHist1D(m_eec_fam_1d + CollBStat, iflat) -> Fill(content.phiCollB);
+        TableHist1D(m_eec_fam_1d + CollYStat, iflat) -> Fill(content.phiCollY);
+        if (m_do_boer_hist) {
+          TableHist1D(m_eec_fam_1d + BoerBStat, iflat) -> Fill(content.phiBoerB);
+          TableHist1D(m_eec_fam_1d + BoerYStat, iflat) -> Fill(content.phiBoerY);
+        }
 
         // fill 2d histograms
-        m_hist_2d[ MakeHashedName("CollinsBlueVsRStat", tag) ] -> Fill(
+        TableHist2D(m_eec_fam_2d + CollBVsRStat, iflat) -> Fill(
           content.rl, content.phiCollB, content.weight
         );
-        m_hist_2d[ MakeHashedName("CollinsYellVsRStat", tag) ] -> Fill(
+        TableHist2D(m_eec_fam_2d + CollYVsRStat, iflat) -> Fill(
           content.rl, content.phiCollY, content.weight
         );
-        m_hist_2d[ MakeHashedName("BoerMuldersBlueVsRStat", tag) ] -> Fill(
-          content.rl, content.phiBoerB, content.weight
-        );
-        m_hist_2d[ MakeHashedName("BoerMuldersYellVsRStat", tag) ] -> Fill(
-          content.rl, content.phiBoerY, content.weight
-        );
+        if (m_do_boer_hist) {
+          TableHist2D(m_eec_fam_2d + BoerBVsRStat, iflat) -> Fill(
+            content.rl, content.phiBoerB, content.weight
+          );
+          TableHist2D(m_eec_fam_2d + BoerYVsRStat, iflat) -> Fill(
+            content.rl, content.phiBoerY, content.weight
+          );
+        }
         return;
 
       }  // end 'FillEECHists(Type::HistIndex&, Type::HistContent&)'
 
+      // ----------------------------------------------------------------------
+      //! Fill EEC histograms for several indices
+      // ----------------------------------------------------------------------
+      /*! With the flat backend, bins are only found once and then
+       *  reused for every index. With the ROOT backend, this is the
+       *  same as filling each index in turn.
+       */
+      void FillEECHists(const Type::IndexList& indices, const Type::HistContent& content) {
+
+        if (m_backend == Type::Root) {
+          for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+            FillEECHists(indices[idx], content);
+          }
+          return;
+        }
+
+        std::size_t cell_1d[NEEC1D];
+        std::size_t cell_2d[NEEC2D];
+        FindEECCells(content, cell_1d, cell_2d);
+        for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+          FillEECCells(FlattenIndex(indices[idx]), cell_1d, cell_2d, content.weight);
+        }
+        return;
+
+      }  // end 'FillEECHists(Type::IndexList&, Type::HistContent&)'
+
+      // ----------------------------------------------------------------------
+      //! Get flattened index of a histogram index
+      // ----------------------------------------------------------------------
+      std::size_t GetFlatIndex(const Type::HistIndex& index) const {return FlattenIndex(index);}
+
+      // ----------------------------------------------------------------------
+      //! Find packed cells of EEC accumulators for a pair
+      // ----------------------------------------------------------------------
+      /*! Packs the 1D cells and then the 2D cells into `cells`, which
+       *  must hold `NEEC1D + NEEC2D` values. These can be stored and
+       *  later refilled with different weights (see `PairCache`).
+       *  Only valid for the flat backend.
+       */
+      void FindEECCells(const Type::HistContent& content, uint32_t* cells) const {
+
+        // throw error if not using flat backend
+        if (!UsesAccumulators()) {
+          assert(UsesAccumulators());
+        }
+
+        // n.b. unused boer-mulders cells are zeroed
+        std::size_t cell_1d[NEEC1D] = {0};
+        std::size_t cell_2d[NEEC2D] = {0};
+        FindEECCells(content, cell_1d, cell_2d);
+        for (std::size_t ihist = 0; ihist < NEEC1D; ++ihist) {
+          cells[ihist] = (uint32_t) cell_1d[ihist];
+        }
+        for (std::size_t ihist = 0; ihist < NEEC2D; ++ihist) {
+          cells[NEEC1D + ihist] = (uint32_t) cell_2d[ihist];
+        }
+        return;
+
+      }  // end 'FindEECCells(Type::HistContent&, uint32_t*)'
+
+      // ----------------------------------------------------------------------
+      //! Fill packed cells of EEC accumulators for several indices
+      // ----------------------------------------------------------------------
+      /*! Counterpart of `FindEECCells(Type::HistContent&, uint32_t*)`:
+       *  `iflats` are flattened histogram indices.
+       */
+      void FillEECCells(
+        const uint32_t* iflats,
+        const std::size_t nflat,
+        const uint32_t* cells,
+        const double weight
+      ) {
+
+        // throw error if not using flat backend
+        if (!UsesAccumulators()) {
+          assert(UsesAccumulators());
+        }
+
+        std::size_t cell_1d[NEEC1D];
+        std::size_t cell_2d[NEEC2D];
+        for (std::size_t ihist = 0; ihist < NEEC1D; ++ihist) {
+          cell_1d[ihist] = cells[ihist];
+        }
+        for (std::size_t ihist = 0; ihist < NEEC2D; ++ihist) {
+          cell_2d[ihist] = cells[NEEC1D + ihist];
+        }
+        for (std::size_t idx = 0; idx < nflat; ++idx) {
+          FillEECCells(iflats[idx], cell_1d, cell_2d, weight);
+        }
+        return;
+
+      }  // end 'FillEECCells(uint32_t*, std::size_t, uint32_t*, double)'
+
+      // ----------------------------------------------------------------------
+      //! Fill E3C histograms
+      // ----------------------------------------------------------------------
+      void FillE3CHists(const Type::HistIndex& index, const Type::HistContent& content) {
+
+        // get position of histograms in tables
+        const std::size_t iflat = FlattenIndex(index);
+
+        // if using flat backend, fill accumulators
+        if (UsesAccumulators()) {
+          std::size_t cell_1d[NE3C1D];
+          std::size_t cell_3d[NE3C3D];
+          FindE3CCells(content, cell_1d, cell_3d);
+          FillE3CCells(iflat, cell_1d, cell_3d, content.weight);
+          return;
+        }
+
+        // throw error if integrated histograms were already reconstructed
+        CheckFillable();
+
+        // fill histograms
+        TableHist1D(m_e3c_fam_1d + E3CStat, iflat) -> Fill(content.rl, content.weight);
+        TableHist3D(m_e3c_fam_3d + E3CXiThetaVsRStat, iflat) -> Fill(
+          content.rl, content.xi, content.theta, content.weight
+        );
+        return;
+
+      }  // end 'FillE3CHists(Type::HistIndex&, Type::HistContent&)'
+
+      // ----------------------------------------------------------------------
+      //! Fill E3C histograms for several indices
+      // ----------------------------------------------------------------------
+      /*! As with EEC histograms, with the flat backend bins are only
+       *  found once and then reused for every index.
+       */
+      void FillE3CHists(const Type::IndexList& indices, const Type::HistContent& content) {
+
+        if (m_backend == Type::Root) {
+          for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+            FillE3CHists(indices[idx], content);
+          }
+          return;
+        }
+
+        std::size_t cell_1d[NE3C1D];
+        std::size_t cell_3d[NE3C3D];
+        FindE3CCells(content, cell_1d, cell_3d);
+        for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+          FillE3CCells(FlattenIndex(indices[idx]), cell_1d, cell_3d, content.weight);
+        }
+        return;
+
+      }  // end 'FillE3CHists(Type::IndexList&, Type::HistContent&)'
+
+      // ----------------------------------------------------------------------
+      //! Fill projected N-point histograms for several indices
+      // ----------------------------------------------------------------------
+      void FillENCHists(const Type::IndexList& indices, const Type::HistContent& content) {
+
+        // if using flat backend, find bin once and fill accumulators
+        if (UsesAccumulators()) {
+          Accumulator&      acc  = m_acc_1d[m_enc_fam_1d];
+          const std::size_t cell = acc.FindBinX(content.rl);
+          for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+            acc.FillCell(FlattenIndex(indices[idx]), cell, content.weight);
+          }
+          return;
+        }
+
+        // throw error if integrated histograms were already reconstructed
+        CheckFillable();
+        for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+          TableHist1D(m_enc_fam_1d, FlattenIndex(indices[idx])) -> Fill(content.rl, content.weight);
+        }
+        return;
+
+      }  // end 'FillENCHists(Type::IndexList&, Type::HistContent&)'
+
+      // ----------------------------------------------------------------------
+      //! Fill leading-hadron histograms for several indices
+      // ----------------------------------------------------------------------
+      void FillLECHists(const Type::IndexList& indices, const Type::HistContent& content) {
+
+        // if using flat backend, find bin once and fill accumulators
+        if (UsesAccumulators()) {
+          Accumulator&      acc  = m_acc_1d[m_lec_fam_1d];
+          const std::size_t cell = acc.FindBinX(content.rl);
+          for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+            acc.FillCell(FlattenIndex(indices[idx]), cell, content.weight);
+          }
+          return;
+        }
+
+        // throw error if integrated histograms were already reconstructed
+        CheckFillable();
+        for (std::size_t idx = 0; idx < indices.Size(); ++idx) {
+          TableHist1D(m_lec_fam_1d, FlattenIndex(indices[idx])) -> Fill(content.rl, content.weight);
+        }
+        return;
+
+      }  // end 'FillLECHists(Type::IndexList&, Type::HistContent&)'
+
+      // ----------------------------------------------------------------------
+      //! Make an empty copy of this manager
+      // ----------------------------------------------------------------------
+      /*! The copy has the same options and, if histograms have been
+       *  generated already, the same histogram layout, but its own
+       *  (empty) histograms. These aren't registered in the current
+       *  ROOT directory, so clones don't clash with the original or
+       *  with each other, and are deleted along with the clone.
+       *
+       *  With the atomic backend, the clone instead shares contents
+       *  with the original, so all clones fill the same arrays.
+       */
+      HistManager Clone() const {
+
+        HistManager clone(*this);
+        clone.m_owned.Reset();
+        clone.m_hist_1d.clear();
+        clone.m_hist_2d.clear();
+        clone.m_hist_3d.clear();
+        clone.m_did_reconstruct = false;
+        clone.m_detached        = true;
+
+        // if atomic backend, clone shares contents of the original
+        //   - n.b. its ROOT histograms will still be its own
+        if (m_backend == Type::Atomic) {
+          clone.m_table_1d.assign(m_table_1d.size(), NULL);
+          clone.m_table_2d.assign(m_table_2d.size(), NULL);
+          clone.m_table_3d.assign(m_table_3d.size(), NULL);
+          return clone;
+        }
+
+        // otherwise regenerate histograms
+        clone.m_table_1d.clear();
+        clone.m_table_2d.clear();
+        clone.m_table_3d.clear();
+        clone.m_acc_1d.clear();
+        clone.m_acc_2d.clear();
+        clone.m_acc_3d.clear();
+
+        // only generate histograms if the original has them
+        if (!m_index_tags.empty()) clone.GenerateHists();
+        return clone;
+
+      }  // end 'Clone()'
+
+      // ----------------------------------------------------------------------
+      //! Add contents of another manager
+      // ----------------------------------------------------------------------
+      /*! Both managers must have the same layout (e.g. one is a clone
+       *  of the other). Histograms are summed one-by-one in a fixed
+       *  order, so merging the same managers in the same order always
+       *  gives the same result. Should be called before `SaveHists`
+       *  and, with the ROOT backend when only finest bins are filled,
+       *  before any histograms are retrieved.
+       *
+       *  With the atomic backend, merging clones which share contents
+       *  does nothing.
+       */
+      void Merge(const HistManager& other) {
+
+        // throw error if layouts don't match
+        const bool same = (m_backend == other.m_backend)
+                       && (m_index_tags == other.m_index_tags)
+                       && (m_table_1d.size() == other.m_table_1d.size())
+                       && (m_table_2d.size() == other.m_table_2d.size())
+                       && (m_table_3d.size() == other.m_table_3d.size())
+                       && (m_acc_1d.size() == other.m_acc_1d.size())
+                       && (m_acc_2d.size() == other.m_acc_2d.size())
+                       && (m_acc_3d.size() == other.m_acc_3d.size());
+        if (!same) {
+          assert(same);
+        }
+
+        // if using flat backend, add accumulators
+        if (UsesAccumulators()) {
+          for (std::size_t ifam = 0; ifam < m_acc_1d.size(); ++ifam) {
+            m_acc_1d[ifam].Add( other.m_acc_1d[ifam] );
+          }
+          for (std::size_t ifam = 0; ifam < m_acc_2d.size(); ++ifam) {
+            m_acc_2d[ifam].Add( other.m_acc_2d[ifam] );
+          }
+          for (std::size_t ifam = 0; ifam < m_acc_3d.size(); ++ifam) {
+            m_acc_3d[ifam].Add( other.m_acc_3d[ifam] );
+          }
+          return;
+        }
+
+        // throw error if integrated histograms were already reconstructed
+        if (m_did_reconstruct || other.m_did_reconstruct) {
+          assert(!m_did_reconstruct && !other.m_did_reconstruct);
+        }
+
+        // otherwise add histograms
+        for (std::size_t ihist = 0; ihist < m_table_1d.size(); ++ihist) {
+          m_table_1d[ihist] -> Add( other.m_table_1d[ihist] );
+        }
+        for (std::size_t ihist = 0; ihist < m_table_2d.size(); ++ihist) {
+          m_table_2d[ihist] -> Add( other.m_table_2d[ihist] );
+        }
+        for (std::size_t ihist = 0; ihist < m_table_3d.size(); ++ihist) {
+          m_table_3d[ihist] -> Add( other.m_table_3d[ihist] );
+        }
+        return;
+
+      }  // end 'Merge(HistManager&)'
+
       // ----------------------------------------------------------------------
       //! Save histograms to a file
       // ----------------------------------------------------------------------
       void SaveHists(TFile* file) {
 
+        // make sure histograms reflect current contents
+        UpdateHists();
+
 #if DO_WIDTH_CALC
         // set variances on relevant histograms
         if (m_do_eec_hist) SetEECVariances();
@@ -600,6 +1665,9 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       TH1D* GetHist1D(const std::string& tag) {
 
+        // make sure histograms reflect current contents
+        UpdateHists();
+
         // throw error if binning doesn't exist
         const unsigned int key = HashString(tag.data());
         if (m_hist_1d.count(key) == 0) {
@@ -616,6 +1684,9 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       TH2D* GetHist2D(const std::string& tag) {
 
+        // make sure histograms reflect current contents
+        UpdateHists();
+
         // throw error if binning doesn't exist
         const unsigned int key = HashString(tag.data());
         if (m_hist_2d.count(key) == 0) {
@@ -632,6 +1703,9 @@ namespace PHEnergyCorrelator {
       // ----------------------------------------------------------------------
       TH3D* GetHist3D(const std::string& tag) {
 
+        // make sure histograms reflect current contents
+        UpdateHists();
+
         // throw error if binning doesn't exist
         const unsigned int key = HashString(tag.data());
         if (m_hist_3d.count(key) == 0) {
@@ -643,6 +1717,32 @@ namespace PHEnergyCorrelator {
 
       }  // end 'GetHist3D(std::string&)'
 
+      // ----------------------------------------------------------------------
+      //! Get all histograms
+      // ----------------------------------------------------------------------
+      /*! Appends every booked histogram to `hists`: 1D, then 2D, then
+       *  3D, each in family-by-index order. Managers with the same
+       *  layout (e.g. a clone and its original) list their histograms
+       *  in the same order, so they can be compared one-by-one.
+       */
+      void GetHists(std::vector<TH1*>& hists) {
+
+        // make sure histograms reflect current contents
+        UpdateHists();
+
+        for (std::size_t ihist = 0; ihist < m_table_1d.size(); ++ihist) {
+          hists.push_back( m_table_1d[ihist] );
+        }
+        for (std::size_t ihist = 0; ihist < m_table_2d.size(); ++ihist) {
+          hists.push_back( m_table_2d[ihist] );
+        }
+        for (std::size_t ihist = 0; ihist < m_table_3d.size(); ++ihist) {
+          hists.push_back( m_table_3d[ihist] );
+        }
+        return;
+
+      }  // end 'GetHists(std::vector<TH1*>&)'
+
       // ----------------------------------------------------------------------
       //! Get a histogram tag from a histogram index
       // ----------------------------------------------------------------------
@@ -659,23 +1759,40 @@ namespace PHEnergyCorrelator {
 
         m_do_eec_hist = false;
         m_do_e3c_hist = false;
+        m_do_enc_hist = false;
+        m_enc_order   = 3;
         m_do_lec_hist = false;
+        m_do_boer_hist = true;
         m_do_pt_bins  = false;
         m_do_cf_bins  = false;
         m_do_ch_bins  = false;
         m_do_sp_bins  = false;
+        m_do_finest   = false;
+        m_did_reconstruct = false;
+        m_detached    = false;
+        m_backend     = Type::Root;
+        m_nstripes    = 8;
         m_nbins_pt    = 0;  // n.b. there will always be 1 additional integrated "bin"
         m_nbins_cf    = 1;
         m_nbins_ch    = 0;  // n.b. there will always be 1 additional integrated "bin"
         m_nbins_sp    = 9;
         m_hist_tag    = "";
         m_hist_pref   = "";
+        m_eec_fam_1d  = 0;
+        m_eec_fam_2d  = 0;
+        m_e3c_fam_1d  = 0;
+        m_e3c_fam_3d  = 0;
+        m_enc_fam_1d  = 0;
+        m_lec_fam_1d  = 0;
 
       }  // end default ctor
 
       // ----------------------------------------------------------------------
       //! default dtor
       // ----------------------------------------------------------------------
+      /*! Histograms of detached managers are deleted by `m_owned`;
+       *  the others belong to the ROOT directory they were made in.
+       */
       ~HistManager() {};
 
       // ----------------------------------------------------------------------
@@ -685,17 +1802,31 @@ namespace PHEnergyCorrelator {
 
         m_do_eec_hist = do_eec;
         m_do_e3c_hist = do_e3c;
+        m_do_enc_hist = false;
+        m_enc_order   = 3;
         m_do_lec_hist = do_lec;
+        m_do_boer_hist = true;
         m_do_pt_bins  = false;
         m_do_cf_bins  = false;
         m_do_ch_bins  = false;
         m_do_sp_bins  = false;
+        m_do_finest   = false;
+        m_did_reconstruct = false;
+        m_detached    = false;
+        m_backend     = Type::Root;
+        m_nstripes    = 8;
         m_nbins_pt    = 0;  // n.b. there will always be 1 additional integrated "bin"
         m_nbins_cf    = 1;
         m_nbins_ch    = 0;  // n.b. there will always be 1 additional integrated "bin"
         m_nbins_sp    = 9;
         m_hist_tag    = "";
         m_hist_pref   = "";
+        m_eec_fam_1d  = 0;
+        m_eec_fam_2d  = 0;
+        m_e3c_fam_1d  = 0;
+        m_e3c_fam_3d  = 0;
+        m_enc_fam_1d  = 0;
+        m_lec_fam_1d  = 0;
 
       }  // end 'HistManager(bool, bool, bool)'
 
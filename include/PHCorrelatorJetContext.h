@@ -0,0 +1,63 @@
+/// ============================================================================
+/*! \file    PHCorrelatorJetContext.h
+ *  \authors Derek Anderson
+ *  \date    10.16.2026
+ *
+ *  Jet-invariant quantities shared by every pair
+ *  (or triplet, etc.) of a jet.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORJETCONTEXT_H
+#define PHCORRELATORJETCONTEXT_H
+
+// c++ utilities
+#include <vector>
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorSpinGeometry.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Per-jet context
+  // ==========================================================================
+  /*! Everything a calculation needs that only depends on the jet:
+   *  its 4-momenta, the indices of the histograms it fills, the weight
+   *  denominator of each weight scheme, and its beam and spin vectors.
+   *  Filled once per jet by `BasicCalculator::LoadJetContext`, and then
+   *  passed to every pair-level calculation of the jet (e.g.
+   *  `BasicCalculator::CalcEEC(JetContext&, ...)`).
+   *
+   *  The unit jet 4-momentum is only calculated if the calculator's
+   *  angle policy uses the jet axis (see `Angles::UsesJetAxis`). The
+   *  spin vectors are only cached for patterns with fixed spins; null
+   *  spins are drawn per pair (see `SpinGeometry::Get`), in which case
+   *  `spin` is NULL. Since `spin` points into the calculator which
+   *  loaded the context, a context should only be used with that
+   *  calculator.
+   */
+  struct JetContext {
+
+    // data members
+    Type::Jet                   jet;
+    Type::Vec4                  vecJet4;
+    Type::Vec4                  unitJet4;
+    Type::IndexList             indices;
+    std::vector<double>         norms;
+    const SpinGeometry::Config* spin;
+
+    //! default ctor/dtor
+    JetContext() : spin(NULL) {};
+    ~JetContext() {};
+
+  };  // end JetContext
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -0,0 +1,969 @@
+/// ============================================================================
+/*! \file    PHCorrelatorKernels.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Vectorized kernels used in ENC calculations
+ *  over all constituents of a jet.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORKERNELS_H
+#define PHCORRELATORKERNELS_H
+
+//! Turns on/off SIMD kernels (only available on x86 with gcc or clang,
+//! and not when interpreted by cling)
+#ifndef PHEC_USE_SIMD
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(__CLING__)
+#define PHEC_USE_SIMD 1
+#else
+#define PHEC_USE_SIMD 0
+#endif
+#endif
+
+//! Stops the compiler from fusing (a * a) + (b * b) into an FMA in the
+//! distance kernels, which it otherwise may when FMA is enabled (e.g.
+//! by -march=native). This keeps every kernel rounding the same way:
+//! `PHEC_NO_FMA` goes before a kernel, and `PHEC_NO_FMA_BODY` at the
+//! top of its body (gcc and clang need different spellings).
+#if defined(__clang__)
+#define PHEC_NO_FMA
+#define PHEC_NO_FMA_BODY _Pragma("clang fp contract(off)")
+#elif defined(__GNUC__)
+#define PHEC_NO_FMA __attribute__((optimize("fp-contract=off")))
+#define PHEC_NO_FMA_BODY
+#else
+#define PHEC_NO_FMA
+#define PHEC_NO_FMA_BODY
+#endif
+
+// c++ utilities
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#if PHEC_USE_SIMD
+#include <immintrin.h>
+#endif
+
+// n.b. unrolled kernels need c++14
+#if __cplusplus >= 201402L
+#include <array>
+#include <utility>
+#endif
+// root libraries
+#include <TMath.h>
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+  namespace Kernel {
+
+    // ------------------------------------------------------------------------
+    //! Instruction sets a kernel can be run with
+    // ------------------------------------------------------------------------
+    enum ISA {Scalar, AVX2, AVX512};
+
+
+
+    // ------------------------------------------------------------------------
+    //! Structure-of-arrays view of a jet's constituents
+    // ------------------------------------------------------------------------
+    /*! Holds the (eta, phi) and 3-momentum of each constituent in
+     *  contiguous arrays so that a whole row of the pair triangle
+     *  can be processed at once. Phi is normalized to [-pi, pi] on
+     *  the way in, so the difference of 2 phis is always within
+     *  (-2pi, 2pi).
+     */
+    struct CstView {
+
+      // data members
+      std::vector<double> eta;
+      std::vector<double> phi;
+      std::vector<double> px;
+      std::vector<double> py;
+      std::vector<double> pz;
+
+      //! no. of constituents
+      std::size_t Size() const {return eta.size();}
+
+      //! clear view (but keep memory)
+      void Clear() {
+        eta.clear();
+        phi.clear();
+        px.clear();
+        py.clear();
+        pz.clear();
+      }
+
+      //! reserve memory for n constituents
+      void Reserve(const std::size_t ncst) {
+        eta.reserve(ncst);
+        phi.reserve(ncst);
+        px.reserve(ncst);
+        py.reserve(ncst);
+        pz.reserve(ncst);
+      }
+
+      //! add a constituent (momentum is only needed for angle kernels)
+      void Add(const Type::Cst& cst, const Type::Vec3& mom = Type::Vec3(0., 0., 0.)) {
+        eta.push_back( cst.eta );
+        phi.push_back( remainder(cst.phi, TMath::TwoPi()) );
+        px.push_back( mom.x );
+        py.push_back( mom.y );
+        pz.push_back( mom.z );
+      }
+
+    };  // end CstView
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get distance between constituents (scalar)
+    // ------------------------------------------------------------------------
+    /*! Fills `dist[ib]` with the (eta, phi) distance between
+     *  constituents `ia` and `ib` for every ib in [0, ia]. The phi
+     *  difference is wrapped into [-pi, pi] with selects rather than
+     *  a call to `remainder`, which is exact for |dphi| < 3pi.
+     */
+    PHEC_NO_FMA void GetCstDistRowScalar(const CstView& view, const std::size_t ia, double* dist) {
+
+      PHEC_NO_FMA_BODY
+      const double eta_a = view.eta[ia];
+      const double phi_a = view.phi[ia];
+      for (std::size_t ib = 0; ib <= ia; ++ib) {
+        const double deta = eta_a - view.eta[ib];
+        double       dphi = phi_a - view.phi[ib];
+        dphi -= (dphi > TMath::Pi())  ? TMath::TwoPi() : 0.0;
+        dphi += (dphi < -TMath::Pi()) ? TMath::TwoPi() : 0.0;
+        dist[ib] = std::sqrt((deta * deta) + (dphi * dphi));
+      }
+      return;
+
+    }  // end 'GetCstDistRowScalar(CstView&, std::size_t, double*)'
+
+
+    // ------------------------------------------------------------------------
+    //! Get distance of a pair slot across jets (scalar)
+    // ------------------------------------------------------------------------
+    /*! For a batch of jets stored jet-major (see `JetBatch`), fills
+     *  `dist[lane]` with the (eta, phi) distance between constituents
+     *  A and B of jet `lane` for every lane in [0, nlane). Here
+     *  `eta_a[lane]` etc. are the coordinates of constituent A of each
+     *  jet. Phi differences are wrapped as in `GetCstDistRowScalar`.
+     */
+    PHEC_NO_FMA void GetCstDistSlotScalar(
+      const double* eta_a,
+      const double* phi_a,
+      const double* eta_b,
+      const double* phi_b,
+      const std::size_t nlane,
+      double* dist
+    ) {
+
+      PHEC_NO_FMA_BODY
+      for (std::size_t lane = 0; lane < nlane; ++lane) {
+        const double deta = eta_a[lane] - eta_b[lane];
+        double       dphi = phi_a[lane] - phi_b[lane];
+        dphi -= (dphi > TMath::Pi())  ? TMath::TwoPi() : 0.0;
+        dphi += (dphi < -TMath::Pi()) ? TMath::TwoPi() : 0.0;
+        dist[lane] = std::sqrt((deta * deta) + (dphi * dphi));
+      }
+      return;
+
+    }  // end 'GetCstDistSlotScalar(double* x 4, std::size_t, double*)'
+
+
+
+#if PHEC_USE_SIMD
+    // ------------------------------------------------------------------------
+    //! Get distance between constituents (AVX2)
+    // ------------------------------------------------------------------------
+    /*! Same as `GetCstDistRowScalar`, but processes 4 pairs at a time.
+     *  Like the scalar kernels, it's compiled without FMAs (see
+     *  `PHEC_NO_FMA`) so that results are identical to theirs.
+     */
+    __attribute__((target("avx2"))) PHEC_NO_FMA
+    void GetCstDistRowAVX2(const CstView& view, const std::size_t ia, double* dist) {
+
+      PHEC_NO_FMA_BODY
+      const __m256d pi     = _mm256_set1_pd(TMath::Pi());
+      const __m256d negpi  = _mm256_set1_pd(-TMath::Pi());
+      const __m256d twopi  = _mm256_set1_pd(TMath::TwoPi());
+      const __m256d eta_a  = _mm256_set1_pd(view.eta[ia]);
+      const __m256d phi_a  = _mm256_set1_pd(view.phi[ia]);
+      const double* eta    = &view.eta[0];
+      const double* phi    = &view.phi[0];
+      const std::size_t nb = ia + 1;
+
+      std::size_t ib = 0;
+      for (; ib + 4 <= nb; ib += 4) {
+        const __m256d deta = _mm256_sub_pd(eta_a, _mm256_loadu_pd(eta + ib));
+        __m256d       dphi = _mm256_sub_pd(phi_a, _mm256_loadu_pd(phi + ib));
+        const __m256d over = _mm256_and_pd(_mm256_cmp_pd(dphi, pi, _CMP_GT_OQ), twopi);
+        const __m256d undr = _mm256_and_pd(_mm256_cmp_pd(dphi, negpi, _CMP_LT_OQ), twopi);
+        dphi = _mm256_add_pd(_mm256_sub_pd(dphi, over), undr);
+        const __m256d dist2 = _mm256_add_pd(_mm256_mul_pd(deta, deta), _mm256_mul_pd(dphi, dphi));
+        _mm256_storeu_pd(dist + ib, _mm256_sqrt_pd(dist2));
+      }
+
+      // do remainder one at a time
+      for (; ib < nb; ++ib) {
+        const double deta = view.eta[ia] - eta[ib];
+        double       dphi = view.phi[ia] - phi[ib];
+        dphi -= (dphi > TMath::Pi())  ? TMath::TwoPi() : 0.0;
+        dphi += (dphi < -TMath::Pi()) ? TMath::TwoPi() : 0.0;
+        dist[ib] = std::sqrt((deta * deta) + (dphi * dphi));
+      }
+      return;
+
+    }  // end 'GetCstDistRowAVX2(CstView&, std::size_t, double*)'
+
+    // n.b. GCC 12 warns that the AVX-512 intrinsics may use an
+    // uninitialized register (a false positive from the intrinsic
+    // headers), so silence that for the AVX-512 kernels
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    // ------------------------------------------------------------------------
+    //! Get distance between constituents (AVX-512)
+    // ------------------------------------------------------------------------
+    /*! Same as `GetCstDistRowScalar`, but processes 8 pairs at a time.
+     *  The remainder of the row is handled with masked loads/stores.
+     *
+     *  N.B. the explicitly-rounded multiplies stop the compiler from
+     *  fusing them into FMAs (which AVX-512 implies) regardless of
+     *  compiler flags, so that results are identical to the other
+     *  kernels.
+     */
+    __attribute__((target("avx512f")))
+    void GetCstDistRowAVX512(const CstView& view, const std::size_t ia, double* dist) {
+
+      const __m512d pi     = _mm512_set1_pd(TMath::Pi());
+      const __m512d negpi  = _mm512_set1_pd(-TMath::Pi());
+      const __m512d twopi  = _mm512_set1_pd(TMath::TwoPi());
+      const __m512d eta_a  = _mm512_set1_pd(view.eta[ia]);
+      const __m512d phi_a  = _mm512_set1_pd(view.phi[ia]);
+      const double* eta    = &view.eta[0];
+      const double* phi    = &view.phi[0];
+      const std::size_t nb = ia + 1;
+
+      for (std::size_t ib = 0; ib < nb; ib += 8) {
+        const __mmask8 load = (nb - ib >= 8) ? (__mmask8) 0xFF : (__mmask8) ((1u << (nb - ib)) - 1u);
+        const __m512d  deta = _mm512_sub_pd(eta_a, _mm512_maskz_loadu_pd(load, eta + ib));
+        __m512d        dphi = _mm512_sub_pd(phi_a, _mm512_maskz_loadu_pd(load, phi + ib));
+        const __mmask8 over = _mm512_cmp_pd_mask(dphi, pi, _CMP_GT_OQ);
+        const __mmask8 undr = _mm512_cmp_pd_mask(dphi, negpi, _CMP_LT_OQ);
+        dphi = _mm512_mask_sub_pd(dphi, over, dphi, twopi);
+        dphi = _mm512_mask_add_pd(dphi, undr, dphi, twopi);
+        const __m512d dist2 = _mm512_add_pd(
+          _mm512_mul_round_pd(deta, deta, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC),
+          _mm512_mul_round_pd(dphi, dphi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+        );
+        _mm512_mask_storeu_pd(dist + ib, load, _mm512_sqrt_pd(dist2));
+      }
+      return;
+
+    }  // end 'GetCstDistRowAVX512(CstView&, std::size_t, double*)'
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    // ------------------------------------------------------------------------
+    //! Get distance of a pair slot across jets (AVX2)
+    // ------------------------------------------------------------------------
+    /*! Same as `GetCstDistSlotScalar`, but processes 4 jets at a time,
+     *  and is compiled without FMAs (see `GetCstDistRowAVX2`).
+     */
+    __attribute__((target("avx2"))) PHEC_NO_FMA
+    void GetCstDistSlotAVX2(
+      const double* eta_a,
+      const double* phi_a,
+      const double* eta_b,
+      const double* phi_b,
+      const std::size_t nlane,
+      double* dist
+    ) {
+
+      PHEC_NO_FMA_BODY
+      const __m256d pi    = _mm256_set1_pd(TMath::Pi());
+      const __m256d negpi = _mm256_set1_pd(-TMath::Pi());
+      const __m256d twopi = _mm256_set1_pd(TMath::TwoPi());
+
+      std::size_t lane = 0;
+      for (; lane + 4 <= nlane; lane += 4) {
+        const __m256d deta = _mm256_sub_pd(_mm256_loadu_pd(eta_a + lane), _mm256_loadu_pd(eta_b + lane));
+        __m256d       dphi = _mm256_sub_pd(_mm256_loadu_pd(phi_a + lane), _mm256_loadu_pd(phi_b + lane));
+        const __m256d over = _mm256_and_pd(_mm256_cmp_pd(dphi, pi, _CMP_GT_OQ), twopi);
+        const __m256d undr = _mm256_and_pd(_mm256_cmp_pd(dphi, negpi, _CMP_LT_OQ), twopi);
+        dphi = _mm256_add_pd(_mm256_sub_pd(dphi, over), undr);
+        const __m256d dist2 = _mm256_add_pd(_mm256_mul_pd(deta, deta), _mm256_mul_pd(dphi, dphi));
+        _mm256_storeu_pd(dist + lane, _mm256_sqrt_pd(dist2));
+      }
+
+      // do remainder one at a time
+      GetCstDistSlotScalar(eta_a + lane, phi_a + lane, eta_b + lane, phi_b + lane, nlane - lane, dist + lane);
+      return;
+
+    }  // end 'GetCstDistSlotAVX2(double* x 4, std::size_t, double*)'
+
+    // n.b. silence the same false positive as for `GetCstDistRowAVX512`
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    // ------------------------------------------------------------------------
+    //! Get distance of a pair slot across jets (AVX-512)
+    // ------------------------------------------------------------------------
+    /*! Same as `GetCstDistSlotScalar`, but processes 8 jets at a time.
+     *  As in `GetCstDistRowAVX512`, multiplies are explicitly rounded
+     *  so that results are identical to the other kernels.
+     */
+    __attribute__((target("avx512f")))
+    void GetCstDistSlotAVX512(
+      const double* eta_a,
+      const double* phi_a,
+      const double* eta_b,
+      const double* phi_b,
+      const std::size_t nlane,
+      double* dist
+    ) {
+
+      const __m512d pi    = _mm512_set1_pd(TMath::Pi());
+      const __m512d negpi = _mm512_set1_pd(-TMath::Pi());
+      const __m512d twopi = _mm512_set1_pd(TMath::TwoPi());
+
+      for (std::size_t lane = 0; lane < nlane; lane += 8) {
+        const __mmask8 load = (nlane - lane >= 8) ? (__mmask8) 0xFF : (__mmask8) ((1u << (nlane - lane)) - 1u);
+        const __m512d  deta = _mm512_sub_pd(
+          _mm512_maskz_loadu_pd(load, eta_a + lane),
+          _mm512_maskz_loadu_pd(load, eta_b + lane)
+        );
+        __m512d dphi = _mm512_sub_pd(
+          _mm512_maskz_loadu_pd(load, phi_a + lane),
+          _mm512_maskz_loadu_pd(load, phi_b + lane)
+        );
+        const __mmask8 over = _mm512_cmp_pd_mask(dphi, pi, _CMP_GT_OQ);
+        const __mmask8 undr = _mm512_cmp_pd_mask(dphi, negpi, _CMP_LT_OQ);
+        dphi = _mm512_mask_sub_pd(dphi, over, dphi, twopi);
+        dphi = _mm512_mask_add_pd(dphi, undr, dphi, twopi);
+        const __m512d dist2 = _mm512_add_pd(
+          _mm512_mul_round_pd(deta, deta, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC),
+          _mm512_mul_round_pd(dphi, dphi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+        );
+        _mm512_mask_storeu_pd(dist + lane, load, _mm512_sqrt_pd(dist2));
+      }
+      return;
+
+    }  // end 'GetCstDistSlotAVX512(double* x 4, std::size_t, double*)'
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+
+
+    // ------------------------------------------------------------------------
+    //! Beam and spin-plane vectors shared by a block of pairs
+    // ------------------------------------------------------------------------
+    /*! The normals of the beam-spin planes (PB x SB and PA x SA)
+     *  only depend on the spin pattern, so they're calculated once
+     *  per block rather than once per pair.
+     */
+    struct SpinPlanes {
+
+      // data members
+      Type::Vec3 unitB;  //!< blue beam direction (PB)
+      Type::Vec3 unitY;  //!< yellow beam direction (PA)
+      Type::Vec3 beamY;  //!< yellow beam vector
+      Type::Vec3 normB;  //!< PB x SB
+      Type::Vec3 normY;  //!< PA x SA
+
+      //! default ctor
+      SpinPlanes() {};
+
+      //! ctor accepting (blue, yellow) beams and spins
+      SpinPlanes(
+        const std::pair<Type::Vec3, Type::Vec3>& beams,
+        const std::pair<Type::Vec3, Type::Vec3>& spins
+      ) {
+        unitB = beams.first.Unit();
+        unitY = beams.second.Unit();
+        beamY = beams.second;
+        normB = unitB.Cross(spins.first);
+        normY = unitY.Cross(spins.second);
+      }  // end ctor(std::pair<Type::Vec3, Type::Vec3>& x 2)
+
+    };  // end SpinPlanes
+
+
+
+    // ------------------------------------------------------------------------
+    //! Wrap an angle in (-2pi, 2pi] into [0, 2pi)
+    // ------------------------------------------------------------------------
+    double WrapAngle(const double angle) {
+
+      double wrapped = angle;
+      wrapped += (wrapped < 0.)              ? TMath::TwoPi() : 0.;
+      wrapped -= (wrapped >= TMath::TwoPi()) ? TMath::TwoPi() : 0.;
+      return wrapped;
+
+    }  // end 'WrapAngle(double)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get angle between 2 planes from (unnormalized) sine and cosine
+    // ------------------------------------------------------------------------
+    /*! If a plane is degenerate (e.g. RC = 0 for a cst paired with
+     *  itself), both are zero and the angle is undefined: NaN is
+     *  returned, like the acos-based calculation would.
+     */
+    double GetPlaneAngle(const double sine, const double cosine) {
+
+      const bool degenerate = (sine == 0.) && (cosine == 0.);
+      return degenerate ? std::numeric_limits<double>::quiet_NaN() : atan2(sine, cosine);
+
+    }  // end 'GetPlaneAngle(double, double)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get dihadron FF angles for a pair
+    // ------------------------------------------------------------------------
+    /*! Sets the blue and yellow "collins" angles of `content` for the
+     *  pair with momenta (`mom_a`, `mom_b`). See `GetDiFFAnglesRow`
+     *  for how they're calculated.
+     */
+    void GetDiFFAngles(
+      const SpinPlanes& planes,
+      const Type::Vec3& mom_a,
+      const Type::Vec3& mom_b,
+      Type::HistContent& content
+    ) {
+
+      // pair vectors
+      const Type::Vec3 pc      = mom_a + mom_b;
+      const Type::Vec3 rc      = 0.5 * (mom_a - mom_b);
+      const Type::Vec3 pc_unit = pc.Unit();
+
+      // blue and yellow spin angles
+      const double thetaSB = GetPlaneAngle(-pc.Dot(planes.normB), planes.unitB.Cross(pc).Dot(planes.normB));
+      const double thetaSA = GetPlaneAngle(-pc.Dot(planes.normY), planes.unitY.Cross(pc).Dot(planes.normY));
+
+      // dihadron angle
+      const double cosRC   = planes.beamY.Dot(rc) - (pc_unit.Dot(planes.beamY) * pc_unit.Dot(rc));
+      const double sinRC   = planes.beamY.Cross(rc).Dot(pc_unit);
+      const double thetaRC = GetPlaneAngle(sinRC, cosRC);
+
+      // wrap into [0, 2pi) and take differences
+      content.phiCollB = WrapAngle( WrapAngle(thetaSB) - WrapAngle(thetaRC) );
+      content.phiCollY = WrapAngle( WrapAngle(thetaSA) - WrapAngle(thetaRC) );
+      return;
+
+    }  // end 'GetDiFFAngles(SpinPlanes&, Type::Vec3& x 2, Type::HistContent&)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get dihadron FF angles for a row of pairs
+    // ------------------------------------------------------------------------
+    /*! Sets the blue and yellow "collins" angles of `contents[ib]` to
+     *  (ThetaSB - ThetaRC) and (ThetaSA - ThetaRC) for every pair
+     *  (ia, ib) with ib in [0, ia], where PC = pA + pB and RC = (pA -
+     *  pB) / 2.
+     *
+     *  Each angle between 2 planes is obtained from atan2(sin, cos)
+     *  of unnormalized dot and triple products, which are scaled by
+     *  the same positive factor, rather than from acos of normalized
+     *  ones plus a branch on the sign of the sine:
+     *    - ThetaSB: cos ~ (PB x PC).(PB x SB), sin ~ -PC.(PB x SB)
+     *    - ThetaSA: cos ~ (PA x PC).(PA x SA), sin ~ -PC.(PA x SA)
+     *    - ThetaRC: cos ~ PA.RC - (PC.PA)(PC.RC), sin ~ (PA x RC).PC
+     *      with PC normalized
+     *  Apart from pairs where a plane is (nearly) degenerate, this
+     *  agrees with the acos-based calculation to ~1e-12.
+     */
+    void GetDiFFAnglesRow(
+      const SpinPlanes& planes,
+      const CstView& view,
+      const std::size_t ia,
+      Type::HistContent* contents
+    ) {
+
+      const Type::Vec3 mom_a(view.px[ia], view.py[ia], view.pz[ia]);
+      for (std::size_t ib = 0; ib <= ia; ++ib) {
+        GetDiFFAngles(
+          planes,
+          mom_a,
+          Type::Vec3(view.px[ib], view.py[ib], view.pz[ib]),
+          contents[ib]
+        );
+      }
+      return;
+
+    }  // end 'GetDiFFAnglesRow(SpinPlanes&, CstView&, std::size_t, Type::HistContent*)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get offset of a row in a packed lower-triangular matrix
+    // ------------------------------------------------------------------------
+    /*! Row `ia` holds entries (ia, ib) for ib in [0, ia], which is
+     *  the same layout `GetCstDistRow` fills.
+     */
+    std::size_t GetTriangleOffset(const std::size_t ia) {
+
+      return (ia * (ia + 1)) / 2;
+
+    }  // end 'GetTriangleOffset(std::size_t)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get E3C triangle shapes for a row of triplets
+    // ------------------------------------------------------------------------
+    /*! For a fixed pair (ia, ib), sets the side lengths (R_L, R_M, R_S),
+     *  xi = R_S / R_M, and theta = asin(sqrt(1 - (R_L - R_M)^2 / R_S^2))
+     *  of `contents[ic]` for every triplet (ia, ib, ic) with ic in
+     *  [0, nc). Here `dist_ac` and `dist_bc` are the rows of distances
+     *  to ia and ib.
+     *
+     *  Sides are sorted with min/max only, so the loop has no branches.
+     *  Degenerate triangles (R_S or R_M = 0) get xi = theta = 0.
+     */
+    void GetE3CShapesRow(
+      const double dist_ab,
+      const double* dist_ac,
+      const double* dist_bc,
+      const std::size_t nc,
+      Type::HistContent* contents
+    ) {
+
+      for (std::size_t ic = 0; ic < nc; ++ic) {
+
+        // sort sides
+        const double lo = std::min(dist_ac[ic], dist_bc[ic]);
+        const double hi = std::max(dist_ac[ic], dist_bc[ic]);
+        const double rl = std::max(dist_ab, hi);
+        const double rs = std::min(dist_ab, lo);
+        const double rm = std::max(lo, std::min(dist_ab, hi));
+
+        // get shape of triangle
+        //   - n.b. the clamp protects against rounding
+        //     pushing (R_L - R_M) above R_S
+        const double ratio = (rs > 0.) ? (rl - rm) / rs : 1.;
+        contents[ic].rl    = rl;
+        contents[ic].rm    = rm;
+        contents[ic].rs    = rs;
+        contents[ic].xi    = (rm > 0.) ? rs / rm : 0.;
+        contents[ic].theta = asin( std::sqrt( std::max(0., 1. - (ratio * ratio)) ) );
+      }
+      return;
+
+    }  // end 'GetE3CShapesRow(double, double*, double*, std::size_t, Type::HistContent*)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get constituents inside a pair
+    // ------------------------------------------------------------------------
+    /*! For the pair (ia, ib) of rank `rank` in a jet's list of pairs
+     *  sorted by R_L, a constituent ic is "inside" if both (ia, ic) and
+     *  (ib, ic) come earlier in the list, i.e. it's closer to both ia
+     *  and ib than they are to each other. `rank_a` and `rank_b` are
+     *  rows ia and ib of the (symmetric) matrix of pair ranks, where
+     *  the diagonal must rank after every pair.
+     */
+    void GetInsideCsts(
+      const std::size_t* rank_a,
+      const std::size_t* rank_b,
+      const std::size_t rank,
+      const std::size_t ncst,
+      std::vector<std::size_t>& inside
+    ) {
+
+      inside.clear();
+      for (std::size_t ic = 0; ic < ncst; ++ic) {
+        if ((rank_a[ic] < rank) && (rank_b[ic] < rank)) {
+          inside.push_back(ic);
+        }
+      }
+      return;
+
+    }  // end 'GetInsideCsts(std::size_t* x 2, std::size_t x 2, std::vector<std::size_t>&)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get elementary symmetric polynomial of a set of weights
+    // ------------------------------------------------------------------------
+    /*! Returns e_{order} of the weights of constituents `csts`. This is
+     *  built up with the update e_k += w * e_{k-1}, which only adds
+     *  positive terms, rather than from power sums via Newton's
+     *  identities, which can cancel badly. `esp` is used as scratch.
+     */
+    double GetSymPoly(
+      const double* weights,
+      const std::vector<std::size_t>& csts,
+      const std::size_t order,
+      std::vector<double>& esp
+    ) {
+
+      esp.assign(order + 1, 0.);
+      esp[0] = 1.;
+      for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+        for (std::size_t k = order; k >= 1; --k) {
+          esp[k] += weights[csts[icst]] * esp[k - 1];
+        }
+      }
+      return esp[order];
+
+    }  // end 'GetSymPoly(double*, std::vector<std::size_t>&, std::size_t, std::vector<double>&)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get summed weights of cliques among a set of constituents
+    // ------------------------------------------------------------------------
+    /*! Returns the sum over all sets of `order` constituents from
+     *  `csts` whose pairs all rank below `rank` of the product of
+     *  their weights. Sets are built up one constituent at a time,
+     *  keeping only candidates that are close enough to every member
+     *  so far, so the cost scales with the number of such sets.
+     *  `ranks` is the full (ncst x ncst) rank matrix and `scratch`
+     *  holds the candidates at each depth (`csts` must not be one of
+     *  its first `order` - 1 entries).
+     */
+    double GetCliqueSum(
+      const std::size_t* ranks,
+      const std::size_t ncst,
+      const std::size_t rank,
+      const double* weights,
+      const std::vector<std::size_t>& csts,
+      const std::size_t order,
+      std::vector< std::vector<std::size_t> >& scratch
+    ) {
+
+      // n.b. with 0 or 1 members, there are no pairs to check
+      if (order == 0) return 1.;
+      if (order == 1) {
+        double sum = 0.;
+        for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+          sum += weights[csts[icst]];
+        }
+        return sum;
+      }
+
+      if (scratch.size() < order) scratch.resize(order);
+      std::vector<std::size_t>& next = scratch[order - 1];
+
+      double sum = 0.;
+      for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+
+        // keep later candidates close enough to this one
+        const std::size_t* rank_c = &ranks[csts[icst] * ncst];
+        next.clear();
+        for (std::size_t jcst = icst + 1; jcst < csts.size(); ++jcst) {
+          if (rank_c[csts[jcst]] < rank) next.push_back(csts[jcst]);
+        }
+        if (next.size() < order - 1) continue;
+
+        // n.b. deeper calls only use lower depths of scratch
+        sum += weights[csts[icst]] * GetCliqueSum(ranks, ncst, rank, weights, next, order - 1, scratch);
+      }
+      return sum;
+
+    }  // end 'GetCliqueSum(std::size_t*, std::size_t x 2, double*, std::vector<std::size_t>&, std::size_t, ...)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Check if an instruction set is supported by the cpu
+    // ------------------------------------------------------------------------
+    bool IsSupported(const ISA isa) {
+
+      switch (isa) {
+#if PHEC_USE_SIMD
+        case AVX512:
+          return __builtin_cpu_supports("avx512f");
+        case AVX2:
+          return __builtin_cpu_supports("avx2");
+#endif
+        case Scalar:
+          return true;
+        default:
+          return false;
+      }
+
+    }  // end 'IsSupported(ISA)'
+
+    // ------------------------------------------------------------------------
+    //! Get best instruction set supported by the cpu
+    // ------------------------------------------------------------------------
+    /*! Only checked once per job.
+     */
+    ISA GetBestISA() {
+
+      static const ISA best = IsSupported(AVX512) ? AVX512 : (IsSupported(AVX2) ? AVX2 : Scalar);
+      return best;
+
+    }  // end 'GetBestISA()'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Get distance between constituents
+    // ------------------------------------------------------------------------
+    /*! Dispatches to the kernel for the requested instruction set,
+     *  which should be supported (see `IsSupported`). All kernels give
+     *  identical results.
+     */
+    void GetCstDistRow(const CstView& view, const std::size_t ia, double* dist, const ISA isa) {
+
+      switch (isa) {
+#if PHEC_USE_SIMD
+        case AVX512:
+          GetCstDistRowAVX512(view, ia, dist);
+          break;
+        case AVX2:
+          GetCstDistRowAVX2(view, ia, dist);
+          break;
+#endif
+        default:
+          GetCstDistRowScalar(view, ia, dist);
+          break;
+      }
+      return;
+
+    }  // end 'GetCstDistRow(CstView&, std::size_t, double*, ISA)'
+
+    // ------------------------------------------------------------------------
+    //! Get distance between constituents with the best kernel available
+    // ------------------------------------------------------------------------
+    void GetCstDistRow(const CstView& view, const std::size_t ia, double* dist) {
+
+      GetCstDistRow(view, ia, dist, GetBestISA());
+      return;
+
+    }  // end 'GetCstDistRow(CstView&, std::size_t, double*)'
+
+    // ------------------------------------------------------------------------
+    //! Get distance of a pair slot across jets
+    // ------------------------------------------------------------------------
+    /*! Dispatches to the slot kernel for the requested instruction
+     *  set (see `GetCstDistRow`). All kernels give identical results.
+     */
+    void GetCstDistSlot(
+      const double* eta_a,
+      const double* phi_a,
+      const double* eta_b,
+      const double* phi_b,
+      const std::size_t nlane,
+      double* dist,
+      const ISA isa
+    ) {
+
+      switch (isa) {
+#if PHEC_USE_SIMD
+        case AVX512:
+          GetCstDistSlotAVX512(eta_a, phi_a, eta_b, phi_b, nlane, dist);
+          break;
+        case AVX2:
+          GetCstDistSlotAVX2(eta_a, phi_a, eta_b, phi_b, nlane, dist);
+          break;
+#endif
+        default:
+          GetCstDistSlotScalar(eta_a, phi_a, eta_b, phi_b, nlane, dist);
+          break;
+      }
+      return;
+
+    }  // end 'GetCstDistSlot(double* x 4, std::size_t, double*, ISA)'
+
+    // ------------------------------------------------------------------------
+    //! Get distance of a pair slot across jets with the best kernel available
+    // ------------------------------------------------------------------------
+    void GetCstDistSlot(
+      const double* eta_a,
+      const double* phi_a,
+      const double* eta_b,
+      const double* phi_b,
+      const std::size_t nlane,
+      double* dist
+    ) {
+
+      GetCstDistSlot(eta_a, phi_a, eta_b, phi_b, nlane, dist, GetBestISA());
+      return;
+
+    }  // end 'GetCstDistSlot(double* x 4, std::size_t, double*)'
+
+
+
+    // ------------------------------------------------------------------------
+    //! Largest no. of constituents with an unrolled triangle kernel
+    // ------------------------------------------------------------------------
+    /*! Row `ia` has `ia + 1` pairs, so rows past the 4th are as wide
+     *  as an AVX2 register and are better off in a row kernel. Past
+     *  4 constituents, unrolling the leading rows alone measured no
+     *  faster than `GetCstDistTriangleGeneric` (see
+     *  test/kernels/SmallJetKernelTest.C), so only jets which can be
+     *  unrolled completely are.
+     */
+    inline std::size_t MaxUnrolled() {return 4;}
+
+    // ------------------------------------------------------------------------
+    //! Get distances of every pair of a jet (generic)
+    // ------------------------------------------------------------------------
+    /*! Fills the packed lower triangle `dist` (see `GetTriangleOffset`)
+     *  a row at a time with `GetCstDistRow` for the requested
+     *  instruction set.
+     */
+    void GetCstDistTriangleGeneric(const CstView& view, double* dist, const ISA isa) {
+
+      for (std::size_t ia = 0; ia < view.Size(); ++ia) {
+        GetCstDistRow(view, ia, dist + GetTriangleOffset(ia), isa);
+      }
+      return;
+
+    }  // end 'GetCstDistTriangleGeneric(CstView&, double*, ISA)'
+
+    void GetCstDistTriangleGeneric(const CstView& view, double* dist) {
+
+      GetCstDistTriangleGeneric(view, dist, GetBestISA());
+      return;
+
+    }  // end 'GetCstDistTriangleGeneric(CstView&, double*)'
+
+
+
+#if __cplusplus >= 201402L
+    // ------------------------------------------------------------------------
+    //! Get distances of one row of an unrolled triangle
+    // ------------------------------------------------------------------------
+    /*! Same arithmetic as `GetCstDistRowScalar`, and likewise compiled
+     *  without FMAs (see `PHEC_NO_FMA`), so results are identical to
+     *  the other kernels. The row length is known at compile time, so
+     *  the compiler is free to fully unroll and vectorize it.
+     */
+    template <std::size_t IA> PHEC_NO_FMA inline void GetCstDistUnrolledRow(
+      const double* eta,
+      const double* phi,
+      double* dist
+    ) {
+
+      PHEC_NO_FMA_BODY
+      double* row = dist + ((IA * (IA + 1)) / 2);
+      for (std::size_t ib = 0; ib <= IA; ++ib) {
+        const double deta = eta[IA] - eta[ib];
+        double       dphi = phi[IA] - phi[ib];
+        dphi -= (dphi > TMath::Pi())  ? TMath::TwoPi() : 0.0;
+        dphi += (dphi < -TMath::Pi()) ? TMath::TwoPi() : 0.0;
+        row[ib] = std::sqrt((deta * deta) + (dphi * dphi));
+      }
+
+    }  // end 'GetCstDistUnrolledRow<std::size_t>(double* x 3)'
+
+    template <std::size_t... IAs> PHEC_NO_FMA inline void GetCstDistUnrolledRows(
+      const double* eta,
+      const double* phi,
+      double* dist,
+      std::index_sequence<IAs...>
+    ) {
+
+      // n.b. expands to 1 call per row, in order
+      const int expand[] = {0, (GetCstDistUnrolledRow<IAs>(eta, phi, dist), 0)...};
+      (void) expand;
+
+      // n.b. unused if there are no rows
+      (void) eta;
+      (void) phi;
+      (void) dist;
+
+    }  // end 'GetCstDistUnrolledRows<std::size_t...>(double* x 3, std::index_sequence<...>)'
+
+    // ------------------------------------------------------------------------
+    //! Get distances of every pair of a jet with N constituents (unrolled)
+    // ------------------------------------------------------------------------
+    /*! Every row is unrolled at compile time, so (eta, phi) of the
+     *  constituents can be kept in registers. `view` must hold
+     *  exactly N constituents, with N at most `MaxUnrolled()`.
+     */
+    template <std::size_t N> PHEC_NO_FMA void GetCstDistTriangleUnrolled(const CstView& view, double* dist) {
+
+      // n.b. copy into fixed-size arrays so the compiler knows N
+      double eta[(N > 0) ? N : 1];
+      double phi[(N > 0) ? N : 1];
+      for (std::size_t icst = 0; icst < N; ++icst) {
+        eta[icst] = view.eta[icst];
+        phi[icst] = view.phi[icst];
+      }
+      GetCstDistUnrolledRows(eta, phi, dist, std::make_index_sequence<N>());
+      return;
+
+    }  // end 'GetCstDistTriangleUnrolled<std::size_t>(CstView&, double*)'
+
+    // ------------------------------------------------------------------------
+    //! Table of unrolled triangle kernels, indexed by no. of constituents
+    // ------------------------------------------------------------------------
+    typedef void (*TriangleKernel)(const CstView&, double*);
+
+    template <std::size_t... Ns> std::array<TriangleKernel, sizeof...(Ns)> MakeTriangleTable(std::index_sequence<Ns...>) {
+
+      const std::array<TriangleKernel, sizeof...(Ns)> table = {{&GetCstDistTriangleUnrolled<Ns>...}};
+      return table;
+
+    }  // end 'MakeTriangleTable<std::size_t...>(std::index_sequence<...>)'
+#endif
+
+    // ------------------------------------------------------------------------
+    //! Get distances of every pair of a jet
+    // ------------------------------------------------------------------------
+    /*! Fills the packed lower triangle `dist` (see `GetTriangleOffset`).
+     *  Jets with 2 to `MaxUnrolled()` constituents use a kernel
+     *  unrolled for their multiplicity (if compiled with c++14 or
+     *  later); larger jets fall back to `GetCstDistTriangleGeneric`
+     *  with the row kernel for `isa`. All kernels give identical
+     *  results.
+     */
+    void GetCstDistTriangle(const CstView& view, double* dist, const ISA isa) {
+
+      const std::size_t ncst = view.Size();
+#if __cplusplus >= 201402L
+      // n.b. sized for 0 to `MaxUnrolled()` constituents
+      static const std::array<TriangleKernel, 5> table = MakeTriangleTable(std::make_index_sequence<5>());
+      if ((ncst >= 2) && (ncst <= MaxUnrolled())) {
+        table[ncst](view, dist);
+        return;
+      }
+#endif
+      (void) ncst;
+      GetCstDistTriangleGeneric(view, dist, isa);
+      return;
+
+    }  // end 'GetCstDistTriangle(CstView&, double*, ISA)'
+
+    // ------------------------------------------------------------------------
+    //! Get distances of every pair of a jet with the best kernels available
+    // ------------------------------------------------------------------------
+    void GetCstDistTriangle(const CstView& view, double* dist) {
+
+      GetCstDistTriangle(view, dist, GetBestISA());
+      return;
+
+    }  // end 'GetCstDistTriangle(CstView&, double*)'
+
+  }  // end Kernel namespace
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
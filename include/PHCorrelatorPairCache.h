@@ -0,0 +1,411 @@
+/// ============================================================================
+/*! \file    PHCorrelatorPairCache.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Class to record the geometry of EEC pairs so
+ *  that they can be refilled with new weights.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORPAIRCACHE_H
+#define PHCORRELATORPAIRCACHE_H
+
+// c++ utilities
+#include <cassert>
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include <vector>
+// analysis components
+#include "PHCorrelatorHistManager.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! EEC pair cache
+  // ==========================================================================
+  /*! Stores, for each jet, the 4-momenta of its constituents, the
+   *  (flattened) histogram indices it fills, and for each pair the
+   *  indices of the 2 constituents plus the accumulator cells of its
+   *  R_{L} and angle bins. Pairs can then be refilled with different
+   *  weights (see `BasicCalculator::ReplayEEC`) without redoing any
+   *  of the kinematics.
+   *
+   *  Jets are kept in memory, or, if a spill file is provided, written
+   *  to it in blocks of `max_pairs` pairs. Jets should be recorded
+   *  first and then replayed; replaying reads back the spill file and
+   *  then whatever is still in memory.
+   *
+   *  N.B. cells are only meaningful for the flat backend, and for
+   *  managers with the same binning as the one that was recorded.
+   */
+  class PairCache {
+
+    public:
+
+      //! no. of packed cells per pair
+      enum {NCells = (int) HistManager::NEEC1D + (int) HistManager::NEEC2D};
+
+      // ----------------------------------------------------------------------
+      //! Record of a jet
+      // ----------------------------------------------------------------------
+      struct JetRecord {
+
+        // data members
+        uint64_t   event;
+        uint64_t   jet;
+        Type::Vec4 jet4;
+        double     evt_weight;
+        uint32_t   ncst;
+        uint32_t   npair;
+        uint32_t   nindex;
+        uint32_t   pad;
+
+        //! default ctor
+        JetRecord() : event(0), jet(0), jet4(Type::Vec3(0., 0., 0.), 0.), evt_weight(1.0), ncst(0), npair(0), nindex(0), pad(0) {};
+
+      };  // end JetRecord
+
+      // ----------------------------------------------------------------------
+      //! Record of a pair
+      // ----------------------------------------------------------------------
+      struct PairRecord {
+
+        // data members
+        uint32_t ia;
+        uint32_t ib;
+        uint32_t cells[NCells];
+
+      };  // end PairRecord
+
+      // ----------------------------------------------------------------------
+      //! A jet being replayed
+      // ----------------------------------------------------------------------
+      /*! Pointers are only valid until the next call to `NextJet`.
+       */
+      struct Block {
+
+        // data members
+        JetRecord         jet;
+        const Type::Vec4* csts;
+        const PairRecord* pairs;
+        const uint32_t*   indices;
+
+        //! default ctor
+        Block() : csts(NULL), pairs(NULL), indices(NULL) {};
+
+      };  // end Block
+
+    private:
+
+      // data members (records in memory)
+      std::vector<JetRecord>  m_jets;
+      std::vector<Type::Vec4> m_csts;
+      std::vector<PairRecord> m_pairs;
+      std::vector<uint32_t>   m_indices;
+
+      // data members (spill file)
+      FILE*       m_file;
+      std::size_t m_max_pairs;
+      std::size_t m_nspill_jets;
+      std::size_t m_nspill_pairs;
+
+      // data members (replay cursor)
+      long                    m_read_pos;
+      bool                    m_read_file;
+      std::size_t             m_read_jet;
+      std::size_t             m_read_cst;
+      std::size_t             m_read_pair;
+      std::size_t             m_read_index;
+      std::vector<Type::Vec4> m_buf_csts;
+      std::vector<PairRecord> m_buf_pairs;
+      std::vector<uint32_t>   m_buf_indices;
+
+      // ----------------------------------------------------------------------
+      //! Read an array from the spill file
+      // ----------------------------------------------------------------------
+      template <typename T> bool ReadArray(std::vector<T>& buffer, const std::size_t size) {
+
+        buffer.resize(size);
+        if (size == 0) return true;
+        return fread(&buffer[0], sizeof(T), size, m_file) == size;
+
+      }  // end 'ReadArray(std::vector<T>&, std::size_t)'
+
+      // ----------------------------------------------------------------------
+      //! Write an array to the spill file
+      // ----------------------------------------------------------------------
+      template <typename T> void WriteArray(const T* array, const std::size_t size) {
+
+        if (size == 0) return;
+
+        // throw error if write failed
+        const std::size_t nwrote = fwrite(array, sizeof(T), size, m_file);
+        if (nwrote != size) {
+          assert(nwrote == size);
+        }
+        return;
+
+      }  // end 'WriteArray(T*, std::size_t)'
+
+    public:
+
+      // ----------------------------------------------------------------------
+      //! Getters
+      // ----------------------------------------------------------------------
+      std::size_t GetNJets()  const {return m_jets.size() + m_nspill_jets;}
+      std::size_t GetNPairs() const {return m_pairs.size() + m_nspill_pairs;}
+      bool        GetSpills() const {return m_file != NULL;}
+
+      // ----------------------------------------------------------------------
+      //! Spill records to a file
+      // ----------------------------------------------------------------------
+      /*! Once more than `max_pairs` pairs are held in memory, they're
+       *  written to `path`. If `append` is true, records already in the
+       *  file (e.g. from an earlier job) are kept and replayed too.
+       */
+      void Spill(const std::string& path, const std::size_t max_pairs = 1000000, const bool append = false) {
+
+        // close any previous file
+        Close();
+
+        // truncate file unless appending
+        if (!append) {
+          FILE* clear = fopen(path.data(), "wb");
+          if (!clear) {
+            assert(clear);
+          }
+          fclose(clear);
+        }
+
+        // throw error if file can't be opened
+        m_file = fopen(path.data(), "a+b");
+        if (!m_file) {
+          assert(m_file);
+        }
+        m_max_pairs = max_pairs;
+        return;
+
+      }  // end 'Spill(std::string&, std::size_t, bool)'
+
+      // ----------------------------------------------------------------------
+      //! Write records in memory to the spill file
+      // ----------------------------------------------------------------------
+      void Flush() {
+
+        if (!m_file) return;
+
+        // write each jet block-by-block
+        std::size_t icst   = 0;
+        std::size_t ipair  = 0;
+        std::size_t iindex = 0;
+        for (std::size_t ijet = 0; ijet < m_jets.size(); ++ijet) {
+          const JetRecord& jet = m_jets[ijet];
+          WriteArray(&jet, 1);
+          WriteArray(jet.ncst   ? &m_csts[icst]      : NULL, jet.ncst);
+          WriteArray(jet.npair  ? &m_pairs[ipair]    : NULL, jet.npair);
+          WriteArray(jet.nindex ? &m_indices[iindex] : NULL, jet.nindex);
+          icst   += jet.ncst;
+          ipair  += jet.npair;
+          iindex += jet.nindex;
+        }
+        fflush(m_file);
+
+        // then clear memory
+        m_nspill_jets  += m_jets.size();
+        m_nspill_pairs += m_pairs.size();
+        m_jets.clear();
+        m_csts.clear();
+        m_pairs.clear();
+        m_indices.clear();
+        return;
+
+      }  // end 'Flush()'
+
+      // ----------------------------------------------------------------------
+      //! Flush and close the spill file
+      // ----------------------------------------------------------------------
+      void Close() {
+
+        if (!m_file) return;
+
+        Flush();
+        fclose(m_file);
+        m_file         = NULL;
+        m_nspill_jets  = 0;
+        m_nspill_pairs = 0;
+        return;
+
+      }  // end 'Close()'
+
+      // ----------------------------------------------------------------------
+      //! Clear records in memory
+      // ----------------------------------------------------------------------
+      void Clear() {
+
+        m_jets.clear();
+        m_csts.clear();
+        m_pairs.clear();
+        m_indices.clear();
+        return;
+
+      }  // end 'Clear()'
+
+      // ----------------------------------------------------------------------
+      //! Start recording a jet
+      // ----------------------------------------------------------------------
+      void BeginJet(
+        const uint64_t event,
+        const uint64_t jet,
+        const Type::Vec4& jet4,
+        const double evt_weight
+      ) {
+
+        m_jets.push_back( JetRecord() );
+        m_jets.back().event      = event;
+        m_jets.back().jet        = jet;
+        m_jets.back().jet4       = jet4;
+        m_jets.back().evt_weight = evt_weight;
+        return;
+
+      }  // end 'BeginJet(uint64_t, uint64_t, Type::Vec4&, double)'
+
+      // ----------------------------------------------------------------------
+      //! Record a constituent, histogram index, or pair of current jet
+      // ----------------------------------------------------------------------
+      void AddCst(const Type::Vec4& cst) {
+
+        m_csts.push_back(cst);
+        ++m_jets.back().ncst;
+        return;
+
+      }  // end 'AddCst(Type::Vec4&)'
+
+      void AddIndex(const std::size_t iflat) {
+
+        m_indices.push_back( (uint32_t) iflat );
+        ++m_jets.back().nindex;
+        return;
+
+      }  // end 'AddIndex(std::size_t)'
+
+      void AddPair(const std::size_t ia, const std::size_t ib, const uint32_t* cells) {
+
+        PairRecord pair;
+        pair.ia = (uint32_t) ia;
+        pair.ib = (uint32_t) ib;
+        for (std::size_t icell = 0; icell < NCells; ++icell) {
+          pair.cells[icell] = cells[icell];
+        }
+        m_pairs.push_back(pair);
+        ++m_jets.back().npair;
+        return;
+
+      }  // end 'AddPair(std::size_t, std::size_t, uint32_t*)'
+
+      // ----------------------------------------------------------------------
+      //! Finish recording a jet
+      // ----------------------------------------------------------------------
+      void EndJet() {
+
+        if (m_file && (m_pairs.size() >= m_max_pairs)) Flush();
+        return;
+
+      }  // end 'EndJet()'
+
+      // ----------------------------------------------------------------------
+      //! Go back to the first jet
+      // ----------------------------------------------------------------------
+      void Rewind() {
+
+        if (m_file) fflush(m_file);
+        m_read_pos   = 0;
+        m_read_file  = (m_file != NULL);
+        m_read_jet   = 0;
+        m_read_cst   = 0;
+        m_read_pair  = 0;
+        m_read_index = 0;
+        return;
+
+      }  // end 'Rewind()'
+
+      // ----------------------------------------------------------------------
+      //! Get next jet to replay
+      // ----------------------------------------------------------------------
+      /*! Returns false once all jets (spilled, then in memory) have been
+       *  read. `Rewind` must be called before the first jet.
+       */
+      bool NextJet(Block& block) {
+
+        // read from spill file first
+        if (m_read_file) {
+          fseek(m_file, m_read_pos, SEEK_SET);
+          if (fread(&block.jet, sizeof(JetRecord), 1, m_file) == 1) {
+
+            // throw error if block is truncated
+            const bool good = ReadArray(m_buf_csts, block.jet.ncst) &&
+                              ReadArray(m_buf_pairs, block.jet.npair) &&
+                              ReadArray(m_buf_indices, block.jet.nindex);
+            if (!good) {
+              assert(good);
+            }
+            block.csts    = m_buf_csts.empty()    ? NULL : &m_buf_csts[0];
+            block.pairs   = m_buf_pairs.empty()   ? NULL : &m_buf_pairs[0];
+            block.indices = m_buf_indices.empty() ? NULL : &m_buf_indices[0];
+            m_read_pos    = ftell(m_file);
+            return true;
+          }
+          m_read_file = false;
+        }
+
+        // then read from memory
+        if (m_read_jet >= m_jets.size()) return false;
+
+        block.jet     = m_jets[m_read_jet];
+        block.csts    = block.jet.ncst   ? &m_csts[m_read_cst]       : NULL;
+        block.pairs   = block.jet.npair  ? &m_pairs[m_read_pair]     : NULL;
+        block.indices = block.jet.nindex ? &m_indices[m_read_index]  : NULL;
+        m_read_cst   += block.jet.ncst;
+        m_read_pair  += block.jet.npair;
+        m_read_index += block.jet.nindex;
+        ++m_read_jet;
+        return true;
+
+      }  // end 'NextJet(Block&)'
+
+      // ----------------------------------------------------------------------
+      //! default ctor/dtor
+      // ----------------------------------------------------------------------
+      PairCache() {
+
+        m_file         = NULL;
+        m_max_pairs    = 0;
+        m_nspill_jets  = 0;
+        m_nspill_pairs = 0;
+        Rewind();
+
+      }  // end default ctor
+
+      ~PairCache() {
+
+        Close();
+
+      }  // end dtor
+
+    private:
+
+      // n.b. owns a file handle, so no copying
+      PairCache(const PairCache&);
+      PairCache& operator=(const PairCache&);
+
+  };  // end PairCache
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -0,0 +1,435 @@
+/// ============================================================================
+/*! \file    PHCorrelatorParallel.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Drivers to split ENC calculations over an entry
+ *  range, or over the pairs of a single jet, across
+ *  several threads.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORPARALLEL_H
+#define PHCORRELATORPARALLEL_H
+
+// c++ utilities
+#include <cmath>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+// n.b. threads need c++11
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+
+
+
+namespace PHEnergyCorrelator {
+  namespace Parallel {
+
+    // ------------------------------------------------------------------------
+    //! Split an entry range into contiguous chunks
+    // ------------------------------------------------------------------------
+    /*! Splits [first, last) into `nchunks` ranges whose sizes differ
+     *  by at most 1. The split only depends on the arguments, so a
+     *  given range is always split the same way.
+     */
+    std::vector< std::pair<int64_t, int64_t> > SplitRange(
+      const int64_t first,
+      const int64_t last,
+      const std::size_t nchunks
+    ) {
+
+      const int64_t nentries = (last > first) ? last - first : 0;
+      const int64_t nuse     = (nchunks > 0) ? (int64_t) nchunks : 1;
+      const int64_t size     = nentries / nuse;
+      const int64_t extra    = nentries % nuse;
+
+      std::vector< std::pair<int64_t, int64_t> > ranges;
+      int64_t start = first;
+      for (int64_t ichunk = 0; ichunk < nuse; ++ichunk) {
+        const int64_t stop = start + size + ((ichunk < extra) ? 1 : 0);
+        ranges.push_back( std::make_pair(start, stop) );
+        start = stop;
+      }
+      return ranges;
+
+    }  // end 'SplitRange(int64_t, int64_t, std::size_t)'
+
+    // ------------------------------------------------------------------------
+    //! Split the pair triangle of a jet into tiles of rows
+    // ------------------------------------------------------------------------
+    /*! Row A of the triangle has the A + 1 pairs (A, B <= A), so
+     *  rows are split into up to `ntiles` contiguous ranges [first,
+     *  last) holding about the same no. of pairs rather than the same
+     *  no. of rows. Later (longer) rows thus get smaller tiles.
+     */
+    std::vector< std::pair<std::size_t, std::size_t> > SplitTriangle(
+      const std::size_t nrows,
+      const std::size_t ntiles
+    ) {
+
+      const std::size_t nuse   = (ntiles > 0) ? ntiles : 1;
+      const double      npairs = 0.5 * (double) nrows * (double) (nrows + 1);
+
+      std::vector< std::pair<std::size_t, std::size_t> > tiles;
+      std::size_t first = 0;
+      for (std::size_t itile = 1; itile <= nuse; ++itile) {
+
+        // find row where cumulative no. of pairs, r(r + 1) / 2,
+        // reaches this tile's share
+        const double target = npairs * ((double) itile / (double) nuse);
+        std::size_t  last   = (itile == nuse)
+          ? nrows
+          : (std::size_t) std::floor(0.5 * (std::sqrt((8. * target) + 1.) - 1.) + 0.5);
+        if (last > nrows) last = nrows;
+
+        // skip empty tiles
+        if (last <= first) continue;
+        tiles.push_back( std::make_pair(first, last) );
+        first = last;
+      }
+      return tiles;
+
+    }  // end 'SplitTriangle(std::size_t, std::size_t)'
+
+#if __cplusplus >= 201103L
+
+    // ------------------------------------------------------------------------
+    //! Run a calculation over an entry range with several threads
+    // ------------------------------------------------------------------------
+    /*! Splits [first, last) with `SplitRange` and gives each chunk to
+     *  its own thread, along with its own shard of `calc` (see
+     *  `BasicCalculator::Clone`). Once all threads are done, shards
+     *  are merged into `calc` in order of thread number, so output is
+     *  reproducible for a given no. of threads.
+     *
+     *  `worker` is called as `worker(shard, begin, end)` and should
+     *  process entries [begin, end) with `shard`. Since TTrees can't be
+     *  shared between threads, it should open its own file/tree, e.g.
+     *
+     *    PHEC::Parallel::Run(calc, [&](PHEC::Calculator& shard, int64_t begin, int64_t end) {
+     *      TFile file(path);
+     *      TTree* tree = (TTree*) file.Get("T");
+     *      ... set branch addresses ...
+     *      for (int64_t entry = begin; entry < end; ++entry) {
+     *        tree -> GetEntry(entry);
+     *        shard.SetEvent(entry);
+     *        ... shard.CalcEECJet(...) ...
+     *      }
+     *    }, 0, nentries, 8);
+     *
+     *  Histograms should be generated (i.e. `Init` called) before this
+     *  is called. With 1 thread, `calc` is used directly.
+     */
+    template <typename Calc, typename Worker> void Run(
+      Calc& calc,
+      Worker worker,
+      const int64_t first,
+      const int64_t last,
+      const std::size_t nthreads
+    ) {
+
+      // if only 1 thread, no need for shards
+      if (nthreads <= 1) {
+        worker(calc, first, last);
+        return;
+      }
+
+      // make a shard for each thread
+      const std::vector< std::pair<int64_t, int64_t> > ranges = SplitRange(first, last, nthreads);
+      std::vector<Calc*> shards;
+      for (std::size_t ithread = 0; ithread < ranges.size(); ++ithread) {
+        shards.push_back( calc.Clone() );
+      }
+
+      // run each chunk on its own thread
+      std::vector<std::thread> threads;
+      for (std::size_t ithread = 0; ithread < ranges.size(); ++ithread) {
+        threads.push_back(
+          std::thread(
+            [&worker, &shards, &ranges, ithread]() {
+              worker(*shards[ithread], ranges[ithread].first, ranges[ithread].second);
+            }
+          )
+        );
+      }
+      for (std::size_t ithread = 0; ithread < threads.size(); ++ithread) {
+        threads[ithread].join();
+      }
+
+      // then merge shards in a fixed order
+      //   - n.b. jets still queued in a batch are processed first
+      for (std::size_t ithread = 0; ithread < shards.size(); ++ithread) {
+        shards[ithread] -> FlushEECBatches();
+        calc.Merge( *shards[ithread] );
+        delete shards[ithread];
+      }
+      return;
+
+    }  // end 'Run(Calc&, Worker, int64_t, int64_t, std::size_t)'
+
+    // ========================================================================
+    //! Pool of threads to split large jets
+    // ========================================================================
+    /*! A few jets with hundreds of constituents can dominate the wall
+     *  time of a job, since their O(n^2) pair loop runs on 1 core.
+     *  `CalcEECJet` splits the pair triangle of any jet with at least
+     *  `threshold` (selected) constituents into tiles of about equal
+     *  no. of pairs (see `SplitTriangle`), which are then processed
+     *  by a pool of threads. Smaller jets (or any jet, if `calc` is
+     *  recording a pair cache) are processed by `calc` directly.
+     *
+     *  Each thread fills its own shard of `calc` (see
+     *  `BasicCalculator::Clone`) and grabs the next unclaimed tile
+     *  when it's done with its current one, so threads that get
+     *  cheap tiles simply do more of them. Shards are merged into
+     *  `calc` in order of thread number by `Finish` (or when the pool
+     *  is destroyed) rather than after every jet, since merging all
+     *  histograms is far more expensive than any 1 jet. With the
+     *  atomic backend, shards share contents with `calc` and there
+     *  is nothing to merge.
+     *
+     *  N.B. which thread fills which tile isn't fixed, so sums can
+     *  differ in the last bits from run to run.
+     *
+     *    PHEC::Parallel::JetPool<PHEC::Calculator> pool(calc, 8);
+     *    for (...) {
+     *      calc.SetEvent(entry);
+     *      pool.CalcEECJet(jet, csts);
+     *    }
+     *    pool.Finish();
+     *    calc.End(file);
+     */
+    template <typename Calc> class JetPool {
+
+      private:
+
+        // data members (calculators)
+        Calc&              m_calc;
+        std::vector<Calc*> m_shards;
+        std::size_t        m_threshold;
+        std::size_t        m_tiles_per_thread;
+        bool               m_finished;
+
+        // data members (threads)
+        std::vector<std::thread> m_threads;
+        std::mutex               m_mutex;
+        std::condition_variable  m_wake;
+        std::condition_variable  m_done;
+        uint64_t                 m_generation;
+        std::size_t              m_nbusy;
+        bool                     m_stop;
+
+        // data members (current jet)
+        const Type::Jet*              m_jet;
+        const std::vector<Type::Cst>* m_csts;
+        double                        m_evt_weight;
+        bool (*m_select)(const Type::Cst&);
+        uint64_t                      m_ievent;
+        uint64_t                      m_ijet;
+        std::vector< std::pair<std::size_t, std::size_t> > m_tiles;
+        std::atomic<std::size_t>      m_next;
+
+        // --------------------------------------------------------------------
+        //! Loop run by each thread
+        // --------------------------------------------------------------------
+        void Work(const std::size_t ithread) {
+
+          Calc&    shard = *m_shards[ithread];
+          uint64_t seen  = 0;
+          while (true) {
+
+            // wait for next jet (or for pool to stop)
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              m_wake.wait(lock, [this, seen]() {return m_stop || (m_generation != seen);});
+              if (m_stop) return;
+              seen = m_generation;
+            }
+
+            // process tiles until none are left
+            shard.SetEvent(m_ievent, m_ijet);
+            for (
+              std::size_t itile = m_next.fetch_add(1);
+              itile < m_tiles.size();
+              itile = m_next.fetch_add(1)
+            ) {
+              shard.CalcEECJetRows(
+                *m_jet,
+                *m_csts,
+                m_tiles[itile].first,
+                m_tiles[itile].second,
+                m_evt_weight,
+                m_select
+              );
+            }
+
+            // then let caller know this thread is done
+            {
+              std::lock_guard<std::mutex> lock(m_mutex);
+              if (--m_nbusy == 0) m_done.notify_one();
+            }
+          }
+
+        }  // end 'Work(std::size_t)'
+
+      public:
+
+        // --------------------------------------------------------------------
+        //! Getters
+        // --------------------------------------------------------------------
+        std::size_t GetNThreads()   const {return m_shards.size();}
+        std::size_t GetThreshold()  const {return m_threshold;}
+
+        // --------------------------------------------------------------------
+        //! Do EEC calculation over all pairs of a jet
+        // --------------------------------------------------------------------
+        /*! Same as `BasicCalculator::CalcEECJet`. The event (and jet)
+         *  should be set on `calc` as usual.
+         */
+        void CalcEECJet(
+          const Type::Jet& jet,
+          const std::vector<Type::Cst>& csts,
+          const double evt_weight = 1.0,
+          bool (*select)(const Type::Cst&) = NULL
+        ) {
+
+          // count selected cst.s
+          std::size_t nrows = csts.size();
+          if (select) {
+            nrows = 0;
+            for (std::size_t icst = 0; icst < csts.size(); ++icst) {
+              if (select(csts[icst])) ++nrows;
+            }
+          }
+
+          // if jet is small (or pairs are being cached), no need to split
+          if (m_shards.empty() || m_finished || (nrows < m_threshold) || m_calc.GetCaching()) {
+            m_calc.CalcEECJet(jet, csts, evt_weight, select);
+            return;
+          }
+
+          // otherwise hand jet to threads
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jet        = &jet;
+            m_csts       = &csts;
+            m_evt_weight = evt_weight;
+            m_select     = select;
+            m_ievent     = m_calc.GetEvent();
+            m_ijet       = m_calc.GetJet();
+            m_tiles      = SplitTriangle(nrows, m_tiles_per_thread * m_shards.size());
+            m_next.store(0);
+            m_nbusy = m_shards.size();
+            ++m_generation;
+          }
+          m_wake.notify_all();
+
+          // wait for them to finish, then move on to next jet
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() {return m_nbusy == 0;});
+          }
+          m_calc.SetJet(m_calc.GetJet() + 1);
+          return;
+
+        }  // end 'CalcEECJet(Type::Jet&, std::vector<Type::Cst>&, double, bool (*)(Type::Cst&))'
+
+        // --------------------------------------------------------------------
+        //! Stop threads and merge shards into calculator
+        // --------------------------------------------------------------------
+        /*! Should be called before `calc` is saved. Afterwards, all
+         *  jets are processed by `calc` directly.
+         */
+        void Finish() {
+
+          if (m_finished) return;
+
+          // stop threads
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+          }
+          m_wake.notify_all();
+          for (std::size_t ithread = 0; ithread < m_threads.size(); ++ithread) {
+            m_threads[ithread].join();
+          }
+
+          // then merge shards in a fixed order
+          for (std::size_t ithread = 0; ithread < m_shards.size(); ++ithread) {
+            m_calc.Merge( *m_shards[ithread] );
+            delete m_shards[ithread];
+          }
+          m_threads.clear();
+          m_shards.clear();
+          m_finished = true;
+          return;
+
+        }  // end 'Finish()'
+
+        // --------------------------------------------------------------------
+        //! ctor accepting arguments
+        // --------------------------------------------------------------------
+        /*! Histograms of `calc` should already be generated (i.e. `Init`
+         *  called). Each thread gets `tiles_per_thread` tiles on
+         *  average, so that threads which finish early can pick up
+         *  the slack.
+         */
+        JetPool(
+          Calc& calc,
+          const std::size_t nthreads,
+          const std::size_t threshold = 64,
+          const std::size_t tiles_per_thread = 4
+        ) : m_calc(calc), m_next(0) {
+
+          m_threshold        = threshold;
+          m_tiles_per_thread = (tiles_per_thread > 0) ? tiles_per_thread : 1;
+          m_finished         = false;
+          m_generation       = 0;
+          m_nbusy            = 0;
+          m_stop             = false;
+          m_jet              = NULL;
+          m_csts             = NULL;
+          m_evt_weight       = 1.0;
+          m_select           = NULL;
+          m_ievent           = 0;
+          m_ijet             = 0;
+
+          // with only 1 thread, calc does everything
+          if (nthreads <= 1) return;
+
+          for (std::size_t ithread = 0; ithread < nthreads; ++ithread) {
+            m_shards.push_back( calc.Clone() );
+          }
+          for (std::size_t ithread = 0; ithread < nthreads; ++ithread) {
+            m_threads.push_back( std::thread(&JetPool::Work, this, ithread) );
+          }
+
+        }  // end ctor(Calc&, std::size_t, std::size_t, std::size_t)
+
+        // --------------------------------------------------------------------
+        //! dtor
+        // --------------------------------------------------------------------
+        ~JetPool() {
+
+          Finish();
+
+        }  // end dtor
+
+    };  // end PHEnergyCorrelator::Parallel::JetPool
+
+#endif
+
+  }  // end Parallel namespace
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -0,0 +1,162 @@
+/// ============================================================================
+/*! \file    PHCorrelatorSpinGeometry.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Class to provide beam and spin vectors (and the
+ *  planes they span) for each spin pattern.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORSPINGEOMETRY_H
+#define PHCORRELATORSPINGEOMETRY_H
+
+// c++ utilities
+#include <stdint.h>
+#include <utility>
+#include <vector>
+// analysis components
+#include "PHCorrelatorAnaTools.h"
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorConstants.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Spin geometry
+  // ==========================================================================
+  /*! Precomputes the spin vectors and beam x spin normals of every
+   *  pp pattern once, so angle calculations don't have to rebuild
+   *  them for each pair.
+   *
+   *  Patterns with a null spin (pAu and unknown patterns) get a
+   *  random spin in the x-y plane. These are drawn from a counter-
+   *  based generator keyed by (seed, event, jet, draw) (see
+   *  `Tools::GetCounterUniform`), so they're reproducible regardless
+   *  of how jets are split among threads. Each thread should own its
+   *  own instance.
+   */
+  class SpinGeometry {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      //! Beam and spin vectors for a spin pattern
+      // ----------------------------------------------------------------------
+      /*! For all pairs, first = blue and second = yellow.
+       */
+      struct Config {
+
+        // data members
+        int                               pattern;
+        std::pair<Type::Vec3, Type::Vec3> beams;
+        std::pair<Type::Vec3, Type::Vec3> spins;
+        std::pair<Type::Vec3, Type::Vec3> unitNorms;  //!< unit(beam x spin)
+        Kernel::SpinPlanes                planes;
+
+        //! default ctor
+        Config() {};
+
+        //! ctor accepting arguments
+        Config(
+          const int pat,
+          const std::pair<Type::Vec3, Type::Vec3>& beamArg,
+          const std::pair<Type::Vec3, Type::Vec3>& spinArg
+        ) : planes(beamArg, spinArg) {
+          pattern   = pat;
+          beams     = beamArg;
+          spins     = spinArg;
+          unitNorms = std::make_pair(
+            ( beams.first.Cross(spins.first) ).Unit(),
+            ( beams.second.Cross(spins.second) ).Unit()
+          );
+        }  // end ctor(int, std::pair<Type::Vec3, Type::Vec3>& x 2)
+
+      };  // end Config
+
+    private:
+
+      // data members
+      uint64_t                          m_seed;
+      std::pair<Type::Vec3, Type::Vec3> m_beams;
+      std::vector<Config>               m_fixed;
+      Config                            m_drawn;
+
+    public:
+
+      // ----------------------------------------------------------------------
+      //! Getters
+      // ----------------------------------------------------------------------
+      uint64_t                          GetSeed()  const {return m_seed;}
+      std::pair<Type::Vec3, Type::Vec3> GetBeams() const {return m_beams;}
+
+      // ----------------------------------------------------------------------
+      //! Setters
+      // ----------------------------------------------------------------------
+      void SetSeed(const uint64_t seed) {m_seed = seed;}
+
+      // ----------------------------------------------------------------------
+      //! Check if a pattern has a null (randomized) spin
+      // ----------------------------------------------------------------------
+      bool HasNullSpin(const int pattern) const {
+
+        return (pattern < Type::PPBUYU) || (pattern > Type::PPBDYD);
+
+      }  // end 'HasNullSpin(int)'
+
+      // ----------------------------------------------------------------------
+      //! Get beam and spin vectors for a pattern
+      // ----------------------------------------------------------------------
+      /*! For pp patterns, (event, jet, draw) are ignored and the
+       *  precomputed vectors are returned. Otherwise, the null spins
+       *  are drawn for the provided key. N.B. the returned reference
+       *  is only valid until the next call.
+       */
+      const Config& Get(
+        const int pattern,
+        const uint64_t event = 0,
+        const uint64_t jet = 0,
+        const uint64_t draw = 0
+      ) {
+
+        if (!HasNullSpin(pattern)) {
+          return m_fixed[pattern];
+        }
+
+        m_drawn = Config(
+          pattern,
+          m_beams,
+          Tools::GetSpinVecs(pattern, m_seed, event, jet, draw)
+        );
+        return m_drawn;
+
+      }  // end 'Get(int, uint64_t x 3)'
+
+      // ----------------------------------------------------------------------
+      //! default ctor/dtor
+      // ----------------------------------------------------------------------
+      /*! Precomputes vectors for every pp pattern.
+       */
+      SpinGeometry(const uint64_t seed = Const::SpinSeed()) {
+
+        m_seed  = seed;
+        m_beams = Tools::GetBeamVecs();
+        for (int pattern = Type::PPBUYU; pattern <= Type::PPBDYD; ++pattern) {
+          m_fixed.push_back( Config(pattern, m_beams, Tools::GetSpinVecs(pattern)) );
+        }
+
+      }  // end ctor(uint64_t)
+
+      ~SpinGeometry() {};
+
+  };  // end SpinGeometry
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
@@ -0,0 +1,162 @@
+/// ============================================================================
+/*! \file    PHCorrelatorVectors.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Lightweight 3- and 4-vectors used internally
+ *  during ENC calculations.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORVECTORS_H
+#define PHCORRELATORVECTORS_H
+
+// c++ utilities
+#include <cmath>
+// root libraries
+#include <TLorentzVector.h>
+#include <TVector3.h>
+
+
+
+namespace PHEnergyCorrelator {
+  namespace Type {
+
+    // ------------------------------------------------------------------------
+    //! Plain 3-vector
+    // ------------------------------------------------------------------------
+    /*! A trivially-copyable stand-in for TVector3 with no virtual
+     *  table. Method names and arithmetic mirror those of TVector3
+     *  so that results are identical.
+     */
+    struct Vec3 {
+
+      // data members
+      double x;
+      double y;
+      double z;
+
+      //! getters
+      double X()  const {return x;}
+      double Y()  const {return y;}
+      double Z()  const {return z;}
+      double Px() const {return x;}
+      double Py() const {return y;}
+      double Pz() const {return z;}
+
+      //! squared magnitude, magnitude
+      double Mag2() const {return (x * x) + (y * y) + (z * z);}
+      double Mag()  const {return std::sqrt(Mag2());}
+
+      //! squared transverse component, transverse component
+      double Perp2() const {return (x * x) + (y * y);}
+      double Perp()  const {return std::sqrt(Perp2());}
+
+      //! dot product
+      double Dot(const Vec3& v) const {
+        return (x * v.x) + (y * v.y) + (z * v.z);
+      }
+
+      //! cross product
+      Vec3 Cross(const Vec3& v) const {
+        return Vec3((y * v.z) - (v.y * z), (z * v.x) - (v.z * x), (x * v.y) - (v.x * y));
+      }
+
+      //! unit vector (returns the vector itself if null)
+      Vec3 Unit() const {
+        const double tot2 = Mag2();
+        const double tot  = (tot2 > 0) ? 1.0 / std::sqrt(tot2) : 1.0;
+        return Vec3(x * tot, y * tot, z * tot);
+      }
+
+      //! scale in place
+      Vec3& operator*=(const double a) {
+        x *= a;
+        y *= a;
+        z *= a;
+        return *this;
+      }
+
+      //! conversion to root
+      TVector3 ToTVector3() const {return TVector3(x, y, z);}
+
+      //! default ctor
+      Vec3() {};
+
+      //! ctor accepting arguments
+      Vec3(const double xarg, const double yarg, const double zarg) {
+        x = xarg;
+        y = yarg;
+        z = zarg;
+      }  // end ctor(double x 3)
+
+      //! ctor accepting a TVector3
+      explicit Vec3(const TVector3& vec) {
+        x = vec.X();
+        y = vec.Y();
+        z = vec.Z();
+      }  // end ctor(TVector3&)
+
+    };  // end Vec3
+
+    //! vector arithmetic
+    inline Vec3 operator+(const Vec3& a, const Vec3& b) {return Vec3(a.x + b.x, a.y + b.y, a.z + b.z);}
+    inline Vec3 operator-(const Vec3& a, const Vec3& b) {return Vec3(a.x - b.x, a.y - b.y, a.z - b.z);}
+    inline Vec3 operator*(const double s, const Vec3& v) {return Vec3(s * v.x, s * v.y, s * v.z);}
+    inline Vec3 operator*(const Vec3& v, const double s) {return Vec3(s * v.x, s * v.y, s * v.z);}
+
+
+
+    // ------------------------------------------------------------------------
+    //! Plain 4-vector
+    // ------------------------------------------------------------------------
+    /*! A trivially-copyable stand-in for TLorentzVector. As with
+     *  `Vec3`, methods mirror those of TLorentzVector.
+     */
+    struct Vec4 {
+
+      // data members
+      Vec3   p;
+      double e;
+
+      //! getters
+      double Px()   const {return p.x;}
+      double Py()   const {return p.y;}
+      double Pz()   const {return p.z;}
+      double E()    const {return e;}
+      double Pt()   const {return p.Perp();}
+      Vec3   Vect() const {return p;}
+
+      //! transverse energy
+      double Et() const {
+        const double pt2  = p.Perp2();
+        const double etet = (pt2 == 0) ? 0 : e * e * pt2 / (pt2 + (p.z * p.z));
+        return (e < 0.0) ? -std::sqrt(etet) : std::sqrt(etet);
+      }
+
+      //! conversion to root
+      TLorentzVector ToTLorentzVector() const {return TLorentzVector(p.x, p.y, p.z, e);}
+
+      //! default ctor
+      Vec4() {};
+
+      //! ctor accepting arguments
+      Vec4(const Vec3& parg, const double earg) {
+        p = parg;
+        e = earg;
+      }  // end ctor(Vec3&, double)
+
+      //! ctor accepting a TLorentzVector
+      explicit Vec4(const TLorentzVector& vec) {
+        p = Vec3(vec.Px(), vec.Py(), vec.Pz());
+        e = vec.E();
+      }  // end ctor(TLorentzVector&)
+
+    };  // end Vec4
+
+  }  // end Type namespace
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end =========================================================================
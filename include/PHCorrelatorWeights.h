@@ -0,0 +1,191 @@
+/// ============================================================================
+/*! \file    PHCorrelatorWeights.h
+ *  \authors Derek Anderson
+ *  \date    10.15.2026
+ *
+ *  Weight policies for the ENC calculator: each
+ *  one defines how constituent weights are
+ *  evaluated.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORWEIGHTS_H
+#define PHCORRELATORWEIGHTS_H
+
+// c++ utilities
+#include <cmath>
+// analysis components
+#include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorVectors.h"
+
+
+
+namespace PHEnergyCorrelator {
+
+  // ==========================================================================
+  //! Runtime weights
+  // ==========================================================================
+  /*! Weight type and power are picked at runtime (i.e. those passed to
+   *  the calculator). A constituent's weight is (cst value)^power over
+   *  (jet value)^power, where the jet denominator (its "norm") is only
+   *  calculated once per jet.
+   *
+   *  Each policy provides `GetNorm` for a jet and `Get` for a
+   *  constituent, plus `GetType` and `GetPower` which resolve the
+   *  type and power a calculator actually uses.
+   */
+  struct RuntimeWeight {
+
+    //! whether or not the type and power are fixed at compile time
+    static const bool IsFixed = false;
+
+    // ------------------------------------------------------------------------
+    //! Resolve weight type and power
+    // ------------------------------------------------------------------------
+    static Type::Weight GetType(const Type::Weight type) {return type;}
+    static double       GetPower(const double power)     {return power;}
+
+    // ------------------------------------------------------------------------
+    //! Get relevant value of a 4-vector
+    // ------------------------------------------------------------------------
+    static double GetValue(const Type::Vec4& vec, const Type::Weight type) {
+
+      switch (type) {
+        case Type::E:
+          return vec.E();
+        case Type::Et:
+          return vec.Et();
+        case Type::Pt:
+          return vec.Pt();
+        default:
+          return vec.Pt();
+      }
+
+    }  // end 'GetValue(Type::Vec4&, Type::Weight)'
+
+    // ------------------------------------------------------------------------
+    //! Raise a value to a power
+    // ------------------------------------------------------------------------
+    /*! Powers of 1 and 2 are done without calling pow, which gives
+     *  identical results.
+     */
+    static double Raise(const double value, const double power) {
+
+      if (power == 1.0) return value;
+      if (power == 2.0) return value * value;
+      return pow(value, power);
+
+    }  // end 'Raise(double, double)'
+
+    // ------------------------------------------------------------------------
+    //! Get norm (i.e. weight denominator) of a jet
+    // ------------------------------------------------------------------------
+    static double GetNorm(const Type::Vec4& jet, const Type::Weight type, const double power) {
+
+      return Raise(GetValue(jet, type), power);
+
+    }  // end 'GetNorm(Type::Vec4&, Type::Weight, double)'
+
+    // ------------------------------------------------------------------------
+    //! Get weight of a constituent
+    // ------------------------------------------------------------------------
+    static double Get(const Type::Vec4& cst, const double norm, const Type::Weight type, const double power) {
+
+      return Raise(GetValue(cst, type), power) / norm;
+
+    }  // end 'Get(Type::Vec4&, double, Type::Weight, double)'
+
+  };  // end RuntimeWeight
+
+
+
+  // ==========================================================================
+  //! Compile-time weight helpers
+  // ==========================================================================
+  namespace Kernel {
+
+    // ------------------------------------------------------------------------
+    //! Relevant value of a 4-vector for a weight type
+    // ------------------------------------------------------------------------
+    template <Type::Weight W> struct WeightValue {
+      static double Get(const Type::Vec4& vec) {return vec.Pt();}
+    };
+
+    template <> struct WeightValue<Type::E> {
+      static double Get(const Type::Vec4& vec) {return vec.E();}
+    };
+
+    template <> struct WeightValue<Type::Et> {
+      static double Get(const Type::Vec4& vec) {return vec.Et();}
+    };
+
+    // ------------------------------------------------------------------------
+    //! Integer power of a value
+    // ------------------------------------------------------------------------
+    /*! Unrolled into P - 1 multiplies. For P = 1, 2 this matches pow
+     *  exactly; higher powers can differ from pow in the last bit.
+     */
+    template <int P> struct WeightPower {
+      static double Raise(const double value) {return value * WeightPower<P - 1>::Raise(value);}
+    };
+
+    template <> struct WeightPower<1> {
+      static double Raise(const double value) {return value;}
+    };
+
+    template <> struct WeightPower<0> {
+      static double Raise(const double) {return 1.0;}
+    };
+
+  }  // end Kernel namespace
+
+
+
+  // ==========================================================================
+  //! Compile-time weights
+  // ==========================================================================
+  /*! Weight type `W` and (integer) power `P` are fixed at compile time,
+   *  so there's no switch or call to pow when evaluating weights. The
+   *  type and power passed to the calculator are ignored. Non-integer
+   *  powers should use `RuntimeWeight`.
+   *
+   *  E.g. a dihadron FF calculator weighting by pt^2:
+   *
+   *    BasicCalculator<DiFFAngles, FixedWeight<Type::Pt, 2> > calc;
+   */
+  template <Type::Weight W, int P> struct FixedWeight {
+
+    //! whether or not the type and power are fixed at compile time
+    static const bool IsFixed = true;
+
+    // ------------------------------------------------------------------------
+    //! Resolve weight type and power
+    // ------------------------------------------------------------------------
+    static Type::Weight GetType(const Type::Weight) {return W;}
+    static double       GetPower(const double)      {return (double) P;}
+
+    // ------------------------------------------------------------------------
+    //! Get norm (i.e. weight denominator) of a jet
+    // ------------------------------------------------------------------------
+    static double GetNorm(const Type::Vec4& jet, const Type::Weight, const double) {
+
+      return Kernel::WeightPower<P>::Raise( Kernel::WeightValue<W>::Get(jet) );
+
+    }  // end 'GetNorm(Type::Vec4&, Type::Weight, double)'
+
+    // ------------------------------------------------------------------------
+    //! Get weight of a constituent
+    // ------------------------------------------------------------------------
+    static double Get(const Type::Vec4& cst, const double norm, const Type::Weight, const double) {
+
+      return Kernel::WeightPower<P>::Raise( Kernel::WeightValue<W>::Get(cst) ) / norm;
+
+    }  // end 'Get(Type::Vec4&, double, Type::Weight, double)'
+
+  };  // end FixedWeight
+
+}  // end PHEnergyCorrelator namespace
+
+#endif
+
+// end ========================================================================
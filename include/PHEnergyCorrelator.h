@@ -12,14 +12,25 @@
 #define PHENERGYCORRELATOR_H
 
 // analysis components
+#include "PHCorrelatorAccumulator.h"
 #include "PHCorrelatorAnaTools.h"
 #include "PHCorrelatorAnaTypes.h"
+#include "PHCorrelatorAngles.h"
+#include "PHCorrelatorBatch.h"
 #include "PHCorrelatorBinning.h"
 #include "PHCorrelatorBins.h"
 #include "PHCorrelatorCalculator.h"
 #include "PHCorrelatorConstants.h"
+#include "PHCorrelatorDispatcher.h"
 #include "PHCorrelatorHistManager.h"
 #include "PHCorrelatorHistogram.h"
+#include "PHCorrelatorJetContext.h"
+#include "PHCorrelatorKernels.h"
+#include "PHCorrelatorPairCache.h"
+#include "PHCorrelatorParallel.h"
+#include "PHCorrelatorSpinGeometry.h"
+#include "PHCorrelatorVectors.h"
+#include "PHCorrelatorWeights.h"
 
 // alias for convenience
 namespace PHEC = PHEnergyCorrelator;
@@ -0,0 +1,243 @@
+/// ============================================================================
+/*! \file    PHCorrelatorTestTools.h
+ *  \authors Derek Anderson
+ *  \date    10.16.2026
+ *
+ *  Fixtures shared by the test macros: fake events,
+ *  a standard calculator set-up, and comparison of
+ *  every histogram of two calculators.
+ */
+/// ============================================================================
+
+#ifndef PHCORRELATORTESTTOOLS_H
+#define PHCORRELATORTESTTOOLS_H
+
+// c++ utilities
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+// root libraries
+#include <TH1.h>
+#include <TMath.h>
+#include <TRandom3.h>
+// analysis header
+#include "../include/PHEnergyCorrelator.h"
+
+
+
+namespace TestTools {
+
+  // ==========================================================================
+  //! Fake event: 1 jet and its constituents
+  // ==========================================================================
+  struct FakeEvent {
+    PHEC::Type::Jet              jet;
+    std::vector<PHEC::Type::Cst> csts;
+  };
+
+
+
+  // --------------------------------------------------------------------------
+  //! Generate a fake event
+  // --------------------------------------------------------------------------
+  /*! The jet's spin pattern is drawn from [0, `nPattern`), so by
+   *  default both pp and pAu patterns are covered.
+   */
+  FakeEvent MakeEvent(TRandom3& rando, const std::size_t nCst, const int nPattern = 6) {
+
+    FakeEvent event;
+    event.jet = PHEC::Type::Jet(
+      rando.Uniform(0.3, 0.9),
+      rando.Uniform(5.0, 20.0),
+      rando.Uniform(-0.5, 0.5),
+      rando.Uniform(-TMath::Pi(), TMath::Pi()),
+      rando.Uniform(-20., 20.),
+      (int) rando.Uniform(0, nPattern)
+    );
+    for (std::size_t icst = 0; icst < nCst; ++icst) {
+      event.csts.push_back(
+        PHEC::Type::Cst(
+          rando.Uniform(0.01, 1.0),
+          rando.Uniform(0.1, 5.0),
+          rando.Uniform(-0.5, 0.5),
+          rando.Uniform(-TMath::Pi(), TMath::Pi()),
+          rando.Uniform(-1.0, 1.0)
+        )
+      );
+    }
+    return event;
+
+  }  // end 'MakeEvent(TRandom3&, std::size_t, int)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Generate fake events
+  // --------------------------------------------------------------------------
+  /*! No. of constituents is drawn from [`minCst`, `maxCst`), or
+   *  is `minCst` for every event if `maxCst <= minCst`.
+   */
+  std::vector<FakeEvent> MakeEvents(
+    TRandom3& rando,
+    const std::size_t nEvt,
+    const std::size_t minCst,
+    const std::size_t maxCst,
+    const int nPattern = 6
+  ) {
+
+    std::vector<FakeEvent> events;
+    for (std::size_t ievt = 0; ievt < nEvt; ++ievt) {
+      const std::size_t ncst = (maxCst > minCst) ? (std::size_t) rando.Uniform(minCst, maxCst) : minCst;
+      events.push_back( MakeEvent(rando, ncst, nPattern) );
+    }
+    return events;
+
+  }  // end 'MakeEvents(TRandom3&, std::size_t x 3, int)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Set up binning of a calculator with pt x charge x spin bins
+  // --------------------------------------------------------------------------
+  /*! Also adds an E^2 weight scheme, so that every comparison
+   *  covers more than one scheme. `Init` is left to the caller,
+   *  so that other options (e.g. ENC order) can be set first.
+   */
+  template <typename Calc> void SetUpBins(
+    Calc& calc,
+    const PHEC::Type::Backend backend = PHEC::Type::Flat,
+    const std::size_t nStripes = 1
+  ) {
+
+    // pt jet bins
+    std::vector< std::pair<float, float> > ptjetbins;
+    ptjetbins.push_back( std::make_pair(5., 10.) );
+    ptjetbins.push_back( std::make_pair(10., 15.) );
+    ptjetbins.push_back( std::make_pair(15., 20.) );
+
+    // charge jet bins
+    std::vector< std::pair<float, float> > chjetbins;
+    chjetbins.push_back( std::make_pair(-100., 0.0) );
+    chjetbins.push_back( std::make_pair(0.0, 100.) );
+
+    calc.SetPtJetBins(ptjetbins);
+    calc.SetChargeBins(chjetbins);
+    calc.SetDoSpinBins(true);
+    calc.SetHistBackend(backend);
+    calc.SetHistStripes(nStripes);
+    calc.AddWeightScheme(PHEC::Type::E, 2.0, "E2");
+    return;
+
+  }  // end 'SetUpBins(Calc&, PHEC::Type::Backend, std::size_t)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Set up an EEC calculator with pt x charge x spin binning
+  // --------------------------------------------------------------------------
+  template <typename Calc> void SetUpCalc(
+    Calc& calc,
+    const PHEC::Type::Backend backend = PHEC::Type::Flat,
+    const std::size_t nStripes = 1
+  ) {
+
+    SetUpBins(calc, backend, nStripes);
+    calc.Init(true);
+    return;
+
+  }  // end 'SetUpCalc(Calc&, PHEC::Type::Backend, std::size_t)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Get weights of a constituent for each scheme of a set-up calculator
+  // --------------------------------------------------------------------------
+  /*! For a calculator with a pt main scheme set up by `SetUpBins`,
+   *  sets `weights[isch]` from the jet norms in `context`, for use
+   *  in brute-force references.
+   */
+  void GetCstWeights(
+    const PHEC::JetContext& context,
+    const PHEC::Type::Cst& cst,
+    std::vector<double>& weights
+  ) {
+
+    const PHEC::Type::Vec4 vecCst4 = PHEC::Tools::GetCstVec(cst, context.jet.pt);
+    weights.resize(2);
+    weights[0] = PHEC::RuntimeWeight::Get(vecCst4, context.norms[0], PHEC::Type::Pt, 1.0);
+    weights[1] = PHEC::RuntimeWeight::Get(vecCst4, context.norms[1], PHEC::Type::E, 2.0);
+    return;
+
+  }  // end 'GetCstWeights(PHEC::JetContext&, PHEC::Type::Cst&, std::vector<double>&)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Get relative difference between two values
+  // --------------------------------------------------------------------------
+  double GetRelDiff(const double ref, const double test) {
+
+    if (ref == test) return 0.;
+    return std::fabs(test - ref) / std::max(std::fabs(ref), std::fabs(test));
+
+  }  // end 'GetRelDiff(double, double)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Get max. relative difference between all histograms of 2 managers
+  // --------------------------------------------------------------------------
+  /*! Compares the contents and errors of every bin (incl. under-
+   *  and overflow) of every booked histogram, spin-sorted ones
+   *  included. A mismatch in layout or in no. of entries counts as
+   *  a difference of 1. If `errors` is false, only contents and
+   *  layout are compared.
+   */
+  double GetMaxDifference(PHEC::HistManager& ref, PHEC::HistManager& test, const bool errors = true) {
+
+    std::vector<TH1*> hRef;
+    std::vector<TH1*> hTest;
+    ref.GetHists(hRef);
+    test.GetHists(hTest);
+    if (hRef.empty() || (hRef.size() != hTest.size())) return 1.;
+
+    double maxDiff = 0.;
+    for (std::size_t ihist = 0; ihist < hRef.size(); ++ihist) {
+      if (hRef[ihist] -> GetNcells() != hTest[ihist] -> GetNcells()) return 1.;
+      if (errors && (hRef[ihist] -> GetEntries() != hTest[ihist] -> GetEntries())) return 1.;
+      for (int ibin = 0; ibin < hRef[ihist] -> GetNcells(); ++ibin) {
+        maxDiff = std::max(maxDiff, GetRelDiff(hRef[ihist] -> GetBinContent(ibin), hTest[ihist] -> GetBinContent(ibin)));
+        if (!errors) continue;
+        maxDiff = std::max(maxDiff, GetRelDiff(hRef[ihist] -> GetBinError(ibin), hTest[ihist] -> GetBinError(ibin)));
+      }
+    }
+    return maxDiff;
+
+  }  // end 'GetMaxDifference(PHEC::HistManager&, PHEC::HistManager&, bool)'
+
+
+
+  // --------------------------------------------------------------------------
+  //! Get max. relative difference between all histograms of 2 calculators
+  // --------------------------------------------------------------------------
+  /*! Compares the histograms of every weight scheme. The calculators
+   *  can have different policies (e.g. fixed vs. runtime weights).
+   */
+  template <typename RefCalc, typename TestCalc> double GetMaxDifference(RefCalc& ref, TestCalc& test, const bool errors = true) {
+
+    if (ref.GetNSchemes() != test.GetNSchemes()) return 1.;
+
+    double maxDiff = 0.;
+    for (std::size_t isch = 0; isch < ref.GetNSchemes(); ++isch) {
+      maxDiff = std::max(maxDiff, GetMaxDifference(ref.GetManager(isch), test.GetManager(isch), errors));
+    }
+    return maxDiff;
+
+  }  // end 'GetMaxDifference(RefCalc&, TestCalc&, bool)'
+
+}  // end TestTools namespace
+
+#endif
+
+// end ========================================================================
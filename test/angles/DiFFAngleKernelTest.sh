@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   DiFFAngleKernelTest.sh
+# \author Derek Anderson
+# \date   10.15.2026
+#
+# Runs dihadron FF angle kernel test.
+# ============================================================================
+
+root -b -q DiFFAngleKernelTest.C++
+
+# end =========================================================================
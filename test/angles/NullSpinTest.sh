@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   NullSpinTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs null spin test.
+# ============================================================================
+
+root -b -q NullSpinTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   E3CTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs E3C test.
+# ============================================================================
+
+root -b -q E3CTest.C++
+
+# end =========================================================================
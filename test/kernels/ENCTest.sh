@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   ENCTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs ENC test.
+# ============================================================================
+
+root -b -q ENCTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   LECTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs LEC test.
+# ============================================================================
+
+root -b -q LECTest.C++
+
+# end =========================================================================
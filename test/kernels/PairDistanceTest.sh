@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   PairDistanceTest.sh
+# \author Derek Anderson
+# \date   10.15.2026
+#
+# Runs pair distance kernel test.
+# ============================================================================
+
+root -b -q PairDistanceTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   SmallJetKernelTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs unrolled small jet kernel test.
+# ============================================================================
+
+root -b -q SmallJetKernelTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   AllocationTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs allocation-counting test.
+# ============================================================================
+
+root -b -q AllocationTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   BatchedJetTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs batched (cross-jet) calculation test.
+# ============================================================================
+
+root -b -q BatchedJetTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   ContentionTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs histogram backend contention test.
+# ============================================================================
+
+root -b -q ContentionTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   DispatcherTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs adaptive dispatcher test.
+# ============================================================================
+
+root -b -q DispatcherTest.C++
+
+# end =========================================================================
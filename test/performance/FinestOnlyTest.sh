@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   FinestOnlyTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs finest-only test.
+# ============================================================================
+
+root -b -q FinestOnlyTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   FixedWeightTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs fixed weight test.
+# ============================================================================
+
+root -b -q FixedWeightTest.C++
+
+# end =========================================================================
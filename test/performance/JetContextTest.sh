@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   JetContextTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs jet context test.
+# ============================================================================
+
+root -b -q JetContextTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   LargeJetTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs large jet (intra-jet threading) test.
+# ============================================================================
+
+root -b -q LargeJetTest.C++
+
+# end =========================================================================
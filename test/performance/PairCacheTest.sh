@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   PairCacheTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs pair cache test.
+# ============================================================================
+
+root -b -q PairCacheTest.C++
+
+# end =========================================================================
@@ -0,0 +1,12 @@
+#!/usr/bin/bash
+# =============================================================================
+# \file   ShardMergeTest.sh
+# \author Derek Anderson
+# \date   10.16.2026
+#
+# Runs shard merge test.
+# ============================================================================
+
+root -b -q ShardMergeTest.C++
+
+# end =========================================================================